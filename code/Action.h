@@ -1,11 +1,31 @@
 #ifndef ACTION_H
 #define ACTION_H
 
+#include <iostream>
 
-class Action {
-    public:
-        virtual bool performAction() = 0;
-        virtual void reverseAction() = 0;
+using namespace std;
+
+//Identifies the type of an action when it is stored in a journal
+enum ActionType{
+    WATER_ACTION,
+    FERTILISE_ACTION,
+    GROW_ACTION,
+    PRUNE_ACTION
 };
 
-#endif
\ No newline at end of file
+//Every action is a value type that is stored directly in the timeline (see ActionRecord.h),
+//so actions are not allocated one at a time and are called without virtual dispatch.
+//Each action provides the following methods:
+//
+//    bool performAction();
+//    void reverseAction();
+//    void redoAction();              Performs the action again after it has been reversed, giving the same result
+//    ActionType getType();
+//    float getCommandAmount();       The amount given to the constructor, which with the type is enough to perform the action again
+//    void writeToJournal(ostream&);  Writes the data needed to reverse and redo the action
+//    void readFromJournal(istream&);
+//
+//Actions only point to the tree and player that they modify, which belong to the game.
+//Any branches that an action needs to restore are stored as copies inside the action.
+
+#endif
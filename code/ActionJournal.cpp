@@ -0,0 +1,47 @@
+#include "ActionJournal.h"
+#include <cstdio>
+
+ActionJournal::ActionJournal(string filePath) : path(filePath) {
+    //Starts with an empty file
+    journalFile.open(path, ios::in | ios::out | ios::binary | ios::trunc);
+
+    if(!journalFile.is_open()){
+        cout << "Error in ActionJournal, could not open " << path << endl;
+    }
+}
+
+ActionJournal::~ActionJournal(){
+    journalFile.close();
+    remove(path.c_str());
+}
+
+streamoff ActionJournal::append(ActionRecord& action){
+    //Records where the action starts before writing it at the end of the file
+    journalFile.seekp(0, ios::end);
+    streamoff position = journalFile.tellp();
+
+    visitAction(action, [&](auto& storedAction){
+        writeValue<int>(journalFile, storedAction.getType());
+        storedAction.writeToJournal(journalFile);
+    });
+
+    return position;
+}
+
+ActionRecord ActionJournal::read(streamoff position, Tree* currentTree, Player* currentPlayer){
+    //Streams the action back in from its position in the file
+    journalFile.seekg(position);
+    ActionType type = (ActionType)readValue<int>(journalFile);
+
+    ActionRecord action = createAction(type, 0, currentTree, currentPlayer);
+    visitAction(action, [&](auto& storedAction){
+        storedAction.readFromJournal(journalFile);
+    });
+
+    if(!journalFile){
+        cout << "Error in ActionJournal.read(), could not read action from " << path << endl;
+        journalFile.clear();
+    }
+
+    return action;
+}
@@ -0,0 +1,31 @@
+#ifndef ACTION_JOURNAL_H
+#define ACTION_JOURNAL_H
+
+#include <fstream>
+#include <string>
+#include "ActionRecord.h"
+#include "Tree.h"
+#include "Player.h"
+
+using namespace std;
+
+//An append-only file of actions that have been moved out of memory by the timeline.
+//Each action is read back from the position that was returned when it was added.
+class ActionJournal {
+    public:
+        ActionJournal(string filePath);
+        //Closes and deletes the journal file
+        ~ActionJournal();
+
+        //Writes an action to the end of the journal and returns its position in the file
+        streamoff append(ActionRecord& action);
+
+        //Reads back the action stored at the given position
+        ActionRecord read(streamoff position, Tree* currentTree, Player* currentPlayer);
+
+    private:
+        string path;
+        fstream journalFile;
+};
+
+#endif
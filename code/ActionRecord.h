@@ -0,0 +1,48 @@
+#ifndef ACTION_RECORD_H
+#define ACTION_RECORD_H
+
+#include <variant>
+#include <type_traits>
+#include "WateringAction.h"
+#include "FertilisingAction.h"
+#include "GrowingAction.h"
+#include "PruningAction.h"
+
+using namespace std;
+
+//Stores any one of the actions by value. The empty state is used for the start of time
+//and for actions that have been moved to the journal.
+typedef variant<monostate, WateringAction, FertilisingAction, GrowingAction, PruningAction> ActionRecord;
+
+//Returns true if the record holds an action
+inline bool hasAction(const ActionRecord& record){
+    return !holds_alternative<monostate>(record);
+}
+
+//Calls a function on the action stored in the record, doing nothing if it is empty
+template <typename Function>
+void visitAction(ActionRecord& record, Function function){
+    visit([&](auto& action){
+        if constexpr (!is_same<decay_t<decltype(action)>, monostate>::value){
+            function(action);
+        }
+    }, record);
+}
+
+//Creates an action of the given type from the amount given to its constructor
+inline ActionRecord createAction(ActionType type, float amount, Tree* currentTree, Player* currentPlayer){
+    switch(type){
+    case WATER_ACTION:
+        return WateringAction(currentPlayer, currentTree, amount);
+    case FERTILISE_ACTION:
+        return FertilisingAction(currentPlayer, currentTree, amount);
+    case GROW_ACTION:
+        return GrowingAction(currentPlayer, currentTree);
+    case PRUNE_ACTION:
+        return PruningAction(currentTree, (int)amount);
+    }
+
+    return monostate();
+}
+
+#endif
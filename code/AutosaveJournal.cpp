@@ -0,0 +1,99 @@
+#include "AutosaveJournal.h"
+#include "SaveFormat.h"
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+//Journals start with these characters, followed by their generation
+const char AUTOSAVE_MAGIC[4] = {'T', 'T', 'T', 'J'};
+
+AutosaveJournal::AutosaveJournal(string snapshotFilePath, string journalFilePath, int recordsBetweenSyncs) :
+    snapshotPath(snapshotFilePath), journalPath(journalFilePath), journalFile(-1), syncInterval(recordsBetweenSyncs), numRecords(0) {};
+
+AutosaveJournal::~AutosaveJournal(){
+    sync();
+    if(journalFile != -1){
+        close(journalFile);
+    }
+}
+
+void AutosaveJournal::append(const AutosaveRecord& record){
+    unsyncedRecords.push_back(record);
+    numRecords++;
+
+    if(unsyncedRecords.size() >= syncInterval){
+        sync();
+    }
+}
+
+void AutosaveJournal::sync(){
+    if(journalFile == -1 || unsyncedRecords.empty()){
+        return;
+    }
+
+    //Writes the whole batch at once, so there is one write and one fsync for every batch of records
+    size_t size = unsyncedRecords.size()*sizeof(AutosaveRecord);
+    if(write(journalFile, unsyncedRecords.data(), size) != size || fsync(journalFile) != 0){
+        cout << "Error in AutosaveJournal.sync(), could not write to " << journalPath << endl;
+    }
+    unsyncedRecords.clear();
+}
+
+int AutosaveJournal::getNumRecords(){
+    return numRecords;
+}
+
+string AutosaveJournal::getNewSnapshotPath(){
+    return snapshotPath + ".new";
+}
+
+void AutosaveJournal::commitSnapshot(unsigned int generation){
+    //A crash leaves either the old or the new snapshot
+    if(!replaceFile(getNewSnapshotPath(), snapshotPath)){
+        return;
+    }
+
+    //The snapshot includes every record, so the journal starts again empty
+    if(journalFile != -1){
+        close(journalFile);
+    }
+    journalFile = open(journalPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(journalFile == -1){
+        cout << "Error in AutosaveJournal.commitSnapshot(), could not create " << journalPath << endl;
+        return;
+    }
+
+    char header[sizeof(AUTOSAVE_MAGIC) + sizeof(generation)];
+    memcpy(header, AUTOSAVE_MAGIC, sizeof(AUTOSAVE_MAGIC));
+    memcpy(header + sizeof(AUTOSAVE_MAGIC), &generation, sizeof(generation));
+    if(write(journalFile, header, sizeof(header)) != sizeof(header) || fsync(journalFile) != 0){
+        cout << "Error in AutosaveJournal.commitSnapshot(), could not write to " << journalPath << endl;
+    }
+
+    unsyncedRecords.clear();
+    numRecords = 0;
+}
+
+vector<AutosaveRecord> AutosaveJournal::readRecords(string journalFilePath, unsigned int generation){
+    vector<AutosaveRecord> records;
+
+    ifstream file(journalFilePath, ios::binary);
+    char magic[sizeof(AUTOSAVE_MAGIC)];
+    unsigned int journalGeneration;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&journalGeneration), sizeof(journalGeneration));
+    if(!file || memcmp(magic, AUTOSAVE_MAGIC, sizeof(magic)) != 0 || journalGeneration != generation){
+        return records;
+    }
+
+    //A crash while writing can leave part of a record at the end, which is ignored
+    AutosaveRecord record;
+    while(file.read(reinterpret_cast<char*>(&record), sizeof(record))){
+        records.push_back(record);
+    }
+
+    return records;
+}
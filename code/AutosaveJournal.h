@@ -0,0 +1,68 @@
+#ifndef AUTOSAVE_JOURNAL_H
+#define AUTOSAVE_JOURNAL_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+//Default number of records that are written to the file together, with a single fsync
+const int DEFAULT_AUTOSAVE_SYNC_INTERVAL = 8;
+
+//Every change to a timeline that the autosave journal records
+enum AutosaveOperation{
+    AUTOSAVE_PERFORM,
+    AUTOSAVE_REVERSE,
+    AUTOSAVE_REDO,
+    AUTOSAVE_TRAVEL,
+    AUTOSAVE_SWITCH
+};
+
+//A single change to a timeline. Performed actions store their type and the amount given to their constructor,
+//travelling stores the step, and switching stores the timeline number.
+struct AutosaveRecord {
+    int operation;
+    int value;
+    float amount;
+};
+
+//An append-only file of the changes made to a timeline since its last snapshot, so autosaving an action
+//takes the same time no matter how big the tree is. Records are collected and written in batches, so a
+//crash loses at most one batch. The journal and snapshot share a generation number, which stops a journal
+//from being replayed on top of a newer snapshot that already includes it.
+class AutosaveJournal {
+    public:
+        AutosaveJournal(string snapshotFilePath, string journalFilePath, int recordsBetweenSyncs = DEFAULT_AUTOSAVE_SYNC_INTERVAL);
+        //Writes any records that have not been written yet
+        ~AutosaveJournal();
+
+        void append(const AutosaveRecord& record);
+
+        //Writes the collected records to the journal and waits until they are stored on disk
+        void sync();
+
+        //Returns the number of records since the last snapshot
+        int getNumRecords();
+
+        //Returns the path that a new snapshot is written to before it replaces the current snapshot
+        string getNewSnapshotPath();
+
+        //Replaces the snapshot with the new one and starts an empty journal with the same generation
+        void commitSnapshot(unsigned int generation);
+
+        //Reads every record in a journal, or no records if the journal belongs to a different generation
+        static vector<AutosaveRecord> readRecords(string journalFilePath, unsigned int generation);
+
+    private:
+        string snapshotPath;
+        string journalPath;
+
+        //File descriptor of the journal, or -1 if no snapshot has been committed yet
+        int journalFile;
+
+        vector<AutosaveRecord> unsyncedRecords;
+        int syncInterval;
+        int numRecords;
+};
+
+#endif
@@ -0,0 +1,79 @@
+#include "BackgroundSaver.h"
+#include "SaveFormat.h"
+#include <iostream>
+#include <cstdio>
+
+BackgroundSaver::BackgroundSaver() : saving(false) {};
+
+BackgroundSaver::~BackgroundSaver(){
+    wait();
+}
+
+bool BackgroundSaver::startSave(Tree* treeCopy, Player* playerCopy, TimelineSave* timelineCopy, string path, function<void()> onSaved){
+    if(saving){
+        delete treeCopy;
+        delete playerCopy;
+        delete timelineCopy;
+        setStatus("Could not save to " + path + ", another save is in progress");
+        return false;
+    }
+
+    //Joins the thread of the previous save, which has already finished
+    wait();
+
+    saving = true;
+    setStatus("Saving...");
+    saveThread = thread(&BackgroundSaver::writeSave, this, treeCopy, playerCopy, timelineCopy, path, onSaved);
+    return true;
+}
+
+bool BackgroundSaver::isSaving(){
+    return saving;
+}
+
+void BackgroundSaver::wait(){
+    if(saveThread.joinable()){
+        saveThread.join();
+    }
+}
+
+string BackgroundSaver::getStatus(){
+    lock_guard<mutex> lock(statusMutex);
+    return status;
+}
+
+void BackgroundSaver::setStatus(string newStatus){
+    lock_guard<mutex> lock(statusMutex);
+    status = newStatus;
+}
+
+void BackgroundSaver::writeSave(Tree* treeCopy, Player* playerCopy, TimelineSave* timelineCopy, string path, function<void()> onSaved){
+    //The old save is only replaced once the new one is complete, so a crash never leaves half a save
+    string temporaryPath = path + ".tmp";
+
+    //The format is chosen by the real path, as the temporary path ends in ".tmp"
+    bool written;
+    if(isJsonSavePath(path)){
+        written = writeJsonSave(temporaryPath, treeCopy, playerCopy, timelineCopy);
+    }else if(isPackedSavePath(path)){
+        written = writePackedSave(temporaryPath, treeCopy, playerCopy);
+    }else{
+        written = writeBinarySave(temporaryPath, treeCopy, playerCopy);
+    }
+
+    if(written && replaceFile(temporaryPath, path)){
+        if(onSaved){
+            onSaved();
+        }
+        setStatus("Game saved to " + path);
+    }else{
+        remove(temporaryPath.c_str());
+        setStatus("Could not save to " + path);
+    }
+
+    delete treeCopy;
+    delete playerCopy;
+    delete timelineCopy;
+
+    saving = false;
+}
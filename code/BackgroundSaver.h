@@ -0,0 +1,53 @@
+#ifndef BACKGROUND_SAVER_H
+#define BACKGROUND_SAVER_H
+
+#include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include "Tree.h"
+#include "Player.h"
+#include "Timeline.h"
+
+using namespace std;
+
+//Writes saves on a separate thread so the game keeps running while large trees are saved.
+//Each save is given its own copies of the game state, which share their branches with the game and so are
+//cheap to take, and is written to a temporary file that replaces the old save only once it is complete.
+class BackgroundSaver {
+    public:
+        BackgroundSaver();
+        //Waits for the save in progress to finish
+        ~BackgroundSaver();
+
+        //Starts saving copies of the game state to the given path, in the format chosen by the end of the path as
+        //in writeSave(). The saver takes ownership of the copies. A timeline is only written to JSON saves, which store
+        //the whole tree and player if it is nullptr. Returns false, freeing the copies and setting the status to say
+        //so, if a save is in progress.
+        //The given function is called on the save thread once the save has replaced the old one.
+        bool startSave(Tree* treeCopy, Player* playerCopy, TimelineSave* timelineCopy, string path, function<void()> onSaved = nullptr);
+
+        bool isSaving();
+
+        //Waits for the save in progress to finish
+        void wait();
+
+        //Returns a message saying whether the last save finished, or an empty string if nothing has been saved
+        string getStatus();
+
+    private:
+        //Writes the save and frees the copies, which runs on the save thread
+        void writeSave(Tree* treeCopy, Player* playerCopy, TimelineSave* timelineCopy, string path, function<void()> onSaved);
+
+        void setStatus(string newStatus);
+
+        thread saveThread;
+        atomic<bool> saving;
+
+        //The status is set by the save thread and read by the game, so it is protected by a mutex
+        mutex statusMutex;
+        string status;
+};
+
+#endif
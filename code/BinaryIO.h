@@ -0,0 +1,108 @@
+#ifndef BINARY_IO_H
+#define BINARY_IO_H
+
+#include <iostream>
+#include <vector>
+#include <cstring>
+
+using namespace std;
+
+//Helpers for writing plain values and vectors of plain values to binary streams
+
+template <typename T>
+void writeValue(ostream& stream, const T& value){
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T readValue(istream& stream){
+    T value;
+    stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return value;
+}
+
+//Vectors are stored as their length followed by their elements
+template <typename T>
+void writeVector(ostream& stream, const vector<T>& values){
+    writeValue<int>(stream, values.size());
+    if(values.size() > 0){
+        stream.write(reinterpret_cast<const char*>(values.data()), values.size()*sizeof(T));
+    }
+}
+
+//Writes only the elements of a vector, for formats that store the length elsewhere
+template <typename T>
+void writeArray(ostream& stream, const vector<T>& values){
+    if(values.size() > 0){
+        stream.write(reinterpret_cast<const char*>(values.data()), values.size()*sizeof(T));
+    }
+}
+
+template <typename T>
+vector<T> readVector(istream& stream){
+    vector<T> values(readValue<int>(stream));
+    if(values.size() > 0){
+        stream.read(reinterpret_cast<char*>(values.data()), values.size()*sizeof(T));
+    }
+    return values;
+}
+
+//Writes a number in groups of 7 bits, lowest first, with the top bit of each byte set if more groups follow,
+//so numbers below 128 take a single byte
+inline void writeVarint(ostream& stream, unsigned int value){
+    while(value >= 0x80){
+        stream.put(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    stream.put(static_cast<char>(value));
+}
+
+//Reads a number written by writeVarint() from memory, moving the position past it.
+//Returns false if the data ends before the number does.
+inline bool readVarint(const char*& position, const char* end, unsigned int& value){
+    value = 0;
+    for(int shift = 0; shift < 35 && position < end; shift += 7){
+        unsigned char byte = *position++;
+        value |= static_cast<unsigned int>(byte & 0x7f) << shift;
+        if((byte & 0x80) == 0){
+            return true;
+        }
+    }
+    return false;
+}
+
+//Maps signed numbers to unsigned ones so that numbers close to zero stay small: 0, -1, 1, -2 become 0, 1, 2, 3
+inline unsigned int zigzagEncode(int value){
+    return (static_cast<unsigned int>(value) << 1) ^ static_cast<unsigned int>(value >> 31);
+}
+
+inline int zigzagDecode(unsigned int value){
+    return static_cast<int>(value >> 1) ^ -static_cast<int>(value & 1);
+}
+
+//Writes a signed number close to zero, such as the difference between two indices, as a varint
+inline void writeSignedVarint(ostream& stream, int value){
+    writeVarint(stream, zigzagEncode(value));
+}
+
+inline bool readSignedVarint(const char*& position, const char* end, int& value){
+    unsigned int encoded;
+    if(!readVarint(position, end, encoded)){
+        return false;
+    }
+    value = zigzagDecode(encoded);
+    return true;
+}
+
+//Reads a plain value from memory, moving the position past it. Returns false if the data ends first.
+template <typename T>
+bool readValue(const char*& position, const char* end, T& value){
+    if(end - position < (long)sizeof(T)){
+        return false;
+    }
+    memcpy(&value, position, sizeof(T));
+    position += sizeof(T);
+    return true;
+}
+
+#endif
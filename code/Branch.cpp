@@ -5,45 +5,81 @@ Branch::Branch(int branchIndex, int parentBranchIndex, float initialAngle, float
 float initialWidth, float initialXPos, float initialYPos): index(branchIndex), parentIndex(parentBranchIndex), age(0) {
     Size size = Size(initialWidth, initialLength);
 
-    //Finds the position of the centre of the branch based on the given position of the base of the branch
-    float xPos = initialXPos+0.5*initialLength*sin(initialAngle * (M_PI / 180));
-    float yPos = initialYPos-0.5*initialLength*cos(initialAngle * (M_PI / 180));
+    branchRect = RotatedRect(Point(0, 0), size, initialAngle);
+    updateDirection();
 
-    Point centre = Point(xPos, yPos);
+    //Finds the position of the centre of the branch based on the given position of the base of the branch
+    float xPos = initialXPos+0.5*initialLength*angleSin;
+    float yPos = initialYPos-0.5*initialLength*angleCos;
 
-    branchRect = RotatedRect(centre, size, initialAngle);
+    branchRect.center = Point(xPos, yPos);
 
 }
 
 Branch::Branch() : Branch(-1, -1, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f) {};
 
+Branch::Branch(int branchIndex, int parentBranchIndex, vector<int> children, RotatedRect rect, int branchAge) :
+    index(branchIndex), parentIndex(parentBranchIndex), childIndices(children), branchRect(rect), age(branchAge) {
+    updateDirection();
+};
+
+void Branch::updateDirection(){
+    angleSin = sin(branchRect.angle * (M_PI / 180));
+    angleCos = cos(branchRect.angle * (M_PI / 180));
+}
+
 
-float Branch::getAngle(){
+float Branch::getAngle() const {
     return branchRect.angle;
 }
 
-void Branch::getTipPos(float &xPosition, float &yPosition) {
-    //Finds position of tip using trigonometry
-    xPosition = branchRect.center.x+0.5*branchRect.size.height*sin(branchRect.angle * (M_PI / 180));
-    yPosition = branchRect.center.y-0.5*branchRect.size.height*cos(branchRect.angle * (M_PI / 180));
+void Branch::getTipPos(float &xPosition, float &yPosition) const {
+    //Finds position of tip using the direction of the branch
+    xPosition = branchRect.center.x+0.5*branchRect.size.height*angleSin;
+    yPosition = branchRect.center.y-0.5*branchRect.size.height*angleCos;
 
     //xPosition = branchRect.center.x;
     //yPosition = branchRect.y;
 }
 
-int Branch::getIndex(){
+int Branch::getIndex() const {
     return index;
 }
 
-int Branch::getParentIndex(){
+int Branch::getParentIndex() const {
     return parentIndex;
 }
 
+const RotatedRect& Branch::getRect() const {
+    return branchRect;
+}
+
+int Branch::getAge() const {
+    return age;
+}
+
 void Branch::addChild(int childIndex) {
     //Adds the new index onto the vector
     childIndices.push_back(childIndex);
 }
 
+void Branch::insertChild(int childIndex, int position){
+    //Adds the child at the end if the position is past the end of the list
+    if(position < 0 || position > childIndices.size()){
+        position = childIndices.size();
+    }
+    childIndices.insert(childIndices.begin() + position, childIndex);
+}
+
+int Branch::getChildPosition(int childIndex) const {
+    for(int i = 0; i < childIndices.size(); i++){
+        if(childIndices[i] == childIndex){
+            return i;
+        }
+    }
+    return -1;
+}
+
 bool Branch::removeChild(int childIndex){
     //Loops through every child of the branch
     for(int i = 0; i < childIndices.size(); i ++){
@@ -60,47 +96,19 @@ bool Branch::removeChild(int childIndex){
 }
 
 
-vector<int> Branch::getChildren(){
+vector<int> Branch::getChildren() const {
     //Returns children
     return childIndices;
 }
 
-float Branch::getSize(){
+float Branch::getSize() const {
     return branchRect.size.area();
 }
 
 void Branch::setPos(float newXPos, float newYPos){
     //Sets the centre of the branch based on the given coordinates, which are at the base of the branch
-    branchRect.center.x = newXPos+0.5*branchRect.size.height*sin(branchRect.angle * (M_PI / 180));
-    branchRect.center.y = newYPos-0.5*branchRect.size.height*cos(branchRect.angle * (M_PI / 180));
-}
-
-void Branch::grow(float areaIncrease, float &widthIncrease, float &lengthIncrease){
-    //The change in length is equal to (n/age) times the change in width, 
-    //so the branch initially grows longer and then later grows wider
-
-    //Set n to an arbitrary value that can be adjusted during testing
-    float n = 20;
-
-    //Increments age by one
-    age++;
-
-    float width = branchRect.size.width;
-    float length = branchRect.size.height;
-
-    //formula for the increase in width derived using the quadratic formula
-    //widthIncrease = -width/2 - (length*age)/(2*n) + 
-    //sqrt((pow(width, 2))/4+(width*length*age)/(2*n)+(length*pow(age, 2))/(4*pow(n, 2)) + age*areaIncrease/n);
-
-    widthIncrease = (-(n*width)/age-length+sqrt(pow((n*width)/age+length, 2)+(4*n*areaIncrease)/age))/(2*n/age);
-
-    lengthIncrease = (n/age)*widthIncrease;
-
-    //Applies changes to variables
-    branchRect.size.width += widthIncrease;
-    branchRect.size.height += lengthIncrease;
-
-
+    branchRect.center.x = newXPos+0.5*branchRect.size.height*angleSin;
+    branchRect.center.y = newYPos-0.5*branchRect.size.height*angleCos;
 }
 
 //Decreases the age by one
@@ -110,6 +118,11 @@ void Branch::decrementAge(){
     }
 }
 
+//Increases the age by one
+void Branch::incrementAge(){
+    age++;
+}
+
 void Branch::modifySize(float widthChange, float lengthChange){
     //Checks that the size modifications are valid
     if(branchRect.size.width + widthChange <= 0 || branchRect.size.height + lengthChange <= 0) {
@@ -122,11 +135,11 @@ void Branch::modifySize(float widthChange, float lengthChange){
     branchRect.size.height += lengthChange;
 }
 
-void Branch::draw(Mat* img){
+void Branch::draw(Mat* img) const {
     Point2f vertices2f[4];
 
     //Gets points of rectangle
-    branchRect.points(vertices2f);
+    getCorners(vertices2f);
 
     //Converts vertices to regular point objects from point2f objects
     vector<Point> vertices;
@@ -173,32 +186,89 @@ void Branch::draw(Mat* img){
 
 }
 
-bool Branch::containsMouse(int mouseX, int mouseY){
+void Branch::getCorners(Point2f corners[4]) const {
+    //The same calculation as RotatedRect::points(), using the stored direction instead of the angle
+    float halfCos = (float)angleCos*0.5f;
+    float halfSin = (float)angleSin*0.5f;
+    const Point2f& centre = branchRect.center;
+    const Size2f& size = branchRect.size;
+
+    corners[0].x = centre.x - halfSin*size.height - halfCos*size.width;
+    corners[0].y = centre.y + halfCos*size.height - halfSin*size.width;
+    corners[1].x = centre.x + halfSin*size.height - halfCos*size.width;
+    corners[1].y = centre.y - halfCos*size.height - halfSin*size.width;
+    corners[2].x = 2*centre.x - corners[0].x;
+    corners[2].y = 2*centre.y - corners[0].y;
+    corners[3].x = 2*centre.x - corners[1].x;
+    corners[3].y = 2*centre.y - corners[1].y;
+}
+
+void Branch::getBounds(Point2f &minCorner, Point2f &maxCorner) const {
+    Point2f corners[4];
+    getCorners(corners);
+
+    minCorner = corners[0];
+    maxCorner = corners[0];
+    for(int i = 1; i < 4; i++){
+        minCorner.x = min(minCorner.x, corners[i].x);
+        minCorner.y = min(minCorner.y, corners[i].y);
+        maxCorner.x = max(maxCorner.x, corners[i].x);
+        maxCorner.y = max(maxCorner.y, corners[i].y);
+    }
+}
+
+bool Branch::overlaps(const Branch& otherBranch) const {
+    Point2f corners[4];
+    Point2f otherCorners[4];
+    getCorners(corners);
+    otherBranch.getCorners(otherCorners);
+
+    //Two rectangles are apart only if there is a gap between them along the direction of one of their sides.
+    //Each rectangle has two directions, which are along its first two sides.
+    const Point2f* rects[2] = {corners, otherCorners};
+    for(int i = 0; i < 4; i++){
+        const Point2f* rect = rects[i/2];
+        float sideX = rect[i%2+1].x - rect[i%2].x;
+        float sideY = rect[i%2+1].y - rect[i%2].y;
+
+        float minDistance = INFINITY;
+        float maxDistance = -INFINITY;
+        float otherMinDistance = INFINITY;
+        float otherMaxDistance = -INFINITY;
+        for(int j = 0; j < 4; j++){
+            float distance = corners[j].x*sideX + corners[j].y*sideY;
+            float otherDistance = otherCorners[j].x*sideX + otherCorners[j].y*sideY;
+            minDistance = min(minDistance, distance);
+            maxDistance = max(maxDistance, distance);
+            otherMinDistance = min(otherMinDistance, otherDistance);
+            otherMaxDistance = max(otherMaxDistance, otherDistance);
+        }
+
+        if(maxDistance < otherMinDistance || otherMaxDistance < minDistance){
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Branch::containsMouse(int mouseX, int mouseY) const {
     //Rotates point around centre of branch
     int newX = mouseX - branchRect.center.x;
     int newY = mouseY - branchRect.center.y;
 
-    //Gets sin and cos of the angle
-    float angleSin = sin(branchRect.angle*M_PI/180);
-    float angleCos = cos(branchRect.angle*M_PI/180);
-
     //Rotates point
-    int rotatedX = newX*angleCos - newY*angleSin;
-    int rotatedY = newX*angleSin - newY*angleCos;
+    int rotatedX = newX*(float)angleCos - newY*(float)angleSin;
+    int rotatedY = newX*(float)angleSin - newY*(float)angleCos;
 
     //Moves the point back to its previous position
     rotatedX += branchRect.center.x;
     rotatedY += branchRect.center.y;
 
-    Point2f rectanglePoints[4];
-
-    //Gets a non-rotated copy of the rectangle
-    RotatedRect unrotatedRect = branchRect;
-    unrotatedRect.angle = 0;
-    unrotatedRect.points(rectanglePoints);
-
-    //Creates unrotated rectangle with the same dimensions as the branch rectangle
-    Rect newRect(rectanglePoints[1], rectanglePoints[3]);
+    //Creates unrotated rectangle with the same dimensions as the branch rectangle, with the same corners that
+    //RotatedRect::points() gives when the angle is 0
+    Point2f topLeft(branchRect.center.x - 0.5f*branchRect.size.width, branchRect.center.y - 0.5f*branchRect.size.height);
+    Point2f bottomRight(2*branchRect.center.x - topLeft.x, 2*branchRect.center.y - topLeft.y);
+    Rect newRect(topLeft, bottomRight);
 
     //Finds whether the rotated point is in the unrotated rectangle
     return newRect.contains(Point(rotatedX, rotatedY));
@@ -240,6 +310,92 @@ nlohmann::json Branch::toJson() const {
     return j;
 }
 
+void Branch::writeJson(JsonWriter& writer) const {
+    writer.beginObject();
+    writer.field("index", index);
+    writer.field("parentIndex", parentIndex);
+
+    writer.key("childIndices");
+    writer.beginArray();
+    for (int childIdx : childIndices) {
+        writer.value(childIdx);
+    }
+    writer.endArray();
+
+    writer.key("branchRect");
+    writer.beginObject();
+    writer.key("center");
+    writer.beginObject();
+    writer.field("x", branchRect.center.x);
+    writer.field("y", branchRect.center.y);
+    writer.endObject();
+    writer.key("size");
+    writer.beginObject();
+    writer.field("width", branchRect.size.width);
+    writer.field("height", branchRect.size.height);
+    writer.endObject();
+    writer.field("angle", branchRect.angle);
+    writer.endObject();
+
+    writer.field("age", age);
+    writer.endObject();
+}
+
+Branch Branch::readJson(JsonReader& reader) {
+    Branch branch;
+    string key;
+    reader.beginObject();
+    while (reader.nextKey(key)) {
+        if (key == "index") {
+            branch.index = reader.readInt();
+        } else if (key == "parentIndex") {
+            branch.parentIndex = reader.readInt();
+        } else if (key == "childIndices") {
+            reader.beginArray();
+            while (reader.nextElement()) {
+                branch.childIndices.push_back(reader.readInt());
+            }
+        } else if (key == "branchRect") {
+            reader.beginObject();
+            while (reader.nextKey(key)) {
+                if (key == "center") {
+                    reader.beginObject();
+                    while (reader.nextKey(key)) {
+                        if (key == "x") {
+                            branch.branchRect.center.x = reader.readFloat();
+                        } else if (key == "y") {
+                            branch.branchRect.center.y = reader.readFloat();
+                        } else {
+                            reader.skipValue();
+                        }
+                    }
+                } else if (key == "size") {
+                    reader.beginObject();
+                    while (reader.nextKey(key)) {
+                        if (key == "width") {
+                            branch.branchRect.size.width = reader.readFloat();
+                        } else if (key == "height") {
+                            branch.branchRect.size.height = reader.readFloat();
+                        } else {
+                            reader.skipValue();
+                        }
+                    }
+                } else if (key == "angle") {
+                    branch.branchRect.angle = reader.readFloat();
+                } else {
+                    reader.skipValue();
+                }
+            }
+        } else if (key == "age") {
+            branch.age = reader.readInt();
+        } else {
+            reader.skipValue();
+        }
+    }
+    branch.updateDirection();
+    return branch;
+}
+
 // Deserialization from JSON
 Branch Branch::fromJson(const nlohmann::json& j) {
     // Note: This creates a Branch instance. The constructor logic for positioning based on initialX, initialY
@@ -288,7 +444,69 @@ Branch Branch::fromJson(const nlohmann::json& j) {
     }
 
     branch.branchRect = RotatedRect(center, size, angle);
+    branch.updateDirection();
     branch.age = j.at("age").get<int>();
     
     return branch;
 }
+
+void Branch::writeBinary(ostream& stream) const {
+    writeValue(stream, index);
+    writeValue(stream, parentIndex);
+    writeVector(stream, childIndices);
+    writeValue(stream, branchRect.center.x);
+    writeValue(stream, branchRect.center.y);
+    writeValue(stream, branchRect.size.width);
+    writeValue(stream, branchRect.size.height);
+    writeValue(stream, branchRect.angle);
+    writeValue(stream, age);
+}
+
+Branch Branch::readBinary(istream& stream){
+    //Fields are read back in the same order they were written
+    Branch branch;
+    branch.index = readValue<int>(stream);
+    branch.parentIndex = readValue<int>(stream);
+    branch.childIndices = readVector<int>(stream);
+    branch.branchRect.center.x = readValue<float>(stream);
+    branch.branchRect.center.y = readValue<float>(stream);
+    branch.branchRect.size.width = readValue<float>(stream);
+    branch.branchRect.size.height = readValue<float>(stream);
+    branch.branchRect.angle = readValue<float>(stream);
+    branch.age = readValue<int>(stream);
+    branch.updateDirection();
+
+    return branch;
+}
+
+unsigned int Branch::addToChecksum(unsigned int checksum) const {
+    checksum = ::addToChecksum(checksum, index);
+    checksum = ::addToChecksum(checksum, parentIndex);
+    for(int i = 0; i < childIndices.size(); i++){
+        checksum = ::addToChecksum(checksum, childIndices[i]);
+    }
+    checksum = ::addToChecksum(checksum, branchRect.center.x);
+    checksum = ::addToChecksum(checksum, branchRect.center.y);
+    checksum = ::addToChecksum(checksum, branchRect.size.width);
+    checksum = ::addToChecksum(checksum, branchRect.size.height);
+    checksum = ::addToChecksum(checksum, branchRect.angle);
+    checksum = ::addToChecksum(checksum, age);
+
+    return checksum;
+}
+
+unsigned int Branch::getHash() const {
+    //The number of children is included, so children cannot be mistaken for the fields after them
+    unsigned int hash = addToHash(CHECKSUM_START, index);
+    hash = addToHash(hash, parentIndex);
+    hash = addToHash(hash, (int)childIndices.size());
+    for(int i = 0; i < childIndices.size(); i++){
+        hash = addToHash(hash, childIndices[i]);
+    }
+    hash = addToHash(hash, branchRect.size.width);
+    hash = addToHash(hash, branchRect.size.height);
+    hash = addToHash(hash, branchRect.angle);
+    hash = addToHash(hash, age);
+
+    return finishHash(hash);
+}
@@ -2,11 +2,14 @@
 #define BRANCH_H
 
 #include "Printable.h"
+#include "BinaryIO.h"
+#include "Checksum.h"
+#include "JsonWriter.h"
+#include "JsonReader.h"
+#include "GrowthPolicy.h"
 
 #include <opencv2/core.hpp>
 #include <opencv2/imgproc.hpp>
-#include <opencv2/highgui.hpp>
-#include <opencv2/highgui/highgui.hpp>
 #include <vector>
 #include <iostream>
 #include <math.h>
@@ -28,46 +31,98 @@ class Branch : public Printable{
         Branch(int branchIndex, int parentBranchIndex, float initialAngle, float initialLength, float initialWidth, 
         float xPos, float yPos);
         Branch();
+        //Creates a branch with exactly the given state, which is used when loading saves
+        Branch(int branchIndex, int parentBranchIndex, vector<int> children, RotatedRect rect, int branchAge);
 
-        float getAngle();
+        float getAngle() const;
 
         //Sets parameters to the position of the tip of the branch
-        void getTipPos(float &xPosition, float &yPosition);
+        void getTipPos(float &xPosition, float &yPosition) const;
 
-        int getIndex();
+        int getIndex() const;
 
-        int getParentIndex();
+        int getParentIndex() const;
+
+        //Returns the rectangle that the branch is drawn as
+        const RotatedRect& getRect() const;
+
+        //Sets the four corners of the rectangle that the branch is drawn as, in the same order as RotatedRect::points()
+        void getCorners(Point2f corners[4]) const;
+
+        //Sets the corners of the smallest box lined up with the axes that contains the whole branch
+        void getBounds(Point2f &minCorner, Point2f &maxCorner) const;
+
+        //Returns true if the rectangles of the two branches overlap or touch
+        bool overlaps(const Branch& otherBranch) const;
+
+        int getAge() const;
         
         //Adds a new branch to the list of child indices
         void addChild(int index);
         //Removes child from list of indices
         bool removeChild(int index);
+        //Adds a child at the given position in the list of child indices
+        void insertChild(int index, int position);
+        //Returns the position of a child in the list of child indices, or -1 if it is not a child
+        int getChildPosition(int index) const;
 
         //Returns the list of children
-        vector<int> getChildren();
+        vector<int> getChildren() const;
         
         //Returns the area of the branch (length*width)
-        float getSize();
+        float getSize() const;
 
         void setPos(float newXPos, float newYPos);
 
-        void grow(float areaIncrease, float &widthIncrease, float &lengthIncrease);
+        //Grows the area of the branch by the given amount, split between the width and length by the growth policy
+        template <typename GrowthPolicy>
+        void grow(float areaIncrease, const GrowthConfig& config, float &widthIncrease, float &lengthIncrease){
+            //Increments age by one
+            age++;
+
+            GrowthPolicy::splitGrowth(branchRect.size.width, branchRect.size.height, age, areaIncrease, config,
+                widthIncrease, lengthIncrease);
+
+            //Applies changes to variables
+            branchRect.size.width += widthIncrease;
+            branchRect.size.height += lengthIncrease;
+        }
 
         void decrementAge();
 
+        void incrementAge();
+
         void modifySize(float widthChange, float lengthChange);
 
-        void draw(Mat* img);
+        void draw(Mat* img) const;
 
-        bool containsMouse(int mouseX, int mouseY);
+        bool containsMouse(int mouseX, int mouseY) const;
 
         void printData();
 
         // Serialization/Deserialization
         nlohmann::json toJson() const;
         static Branch fromJson(const nlohmann::json& j);
+        //Writes the same JSON as toJson() straight to a writer
+        void writeJson(JsonWriter& writer) const;
+        //Reads a branch written by writeJson() or toJson() straight from a reader
+        static Branch readJson(JsonReader& reader);
+
+        //Adds every field of the branch to a checksum and returns the new checksum
+        unsigned int addToChecksum(unsigned int checksum) const;
+
+        //Returns a hash of every field of the branch except its position, which trees add up to keep a hash of all
+        //of their branches. The position is left out, as trees only work it out when it is needed.
+        unsigned int getHash() const;
+
+        //Binary serialization used by the timeline journal
+        void writeBinary(ostream& stream) const;
+        static Branch readBinary(istream& stream);
 
     private:
+        //Works out the direction of the branch from its angle, which must be called whenever the angle is set
+        void updateDirection();
+
         //Index of branch in tree
         int index;
         //Indices of all branches stemming from this branch
@@ -79,6 +134,11 @@ class Branch : public Printable{
         //Rectangle representing the branch
         RotatedRect branchRect;
 
+        //Sine and cosine of the angle, so positions are found without trigonometry. The angle never changes once the
+        //branch is created, and they are kept in double precision so the positions are exactly the same as before.
+        double angleSin;
+        double angleCos;
+
         //Number of times the branch has been allowed to grow
         int age;
 };
@@ -0,0 +1,47 @@
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <cstring>
+
+//Starting value of a checksum before any values are added to it
+const unsigned int CHECKSUM_START = 2166136261u;
+
+//Mixes the bytes of a value into a 32 bit FNV-1a checksum and returns the new checksum
+template <typename T>
+unsigned int addToChecksum(unsigned int checksum, const T& value){
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+    for(int i = 0; i < sizeof(T); i++){
+        checksum ^= bytes[i];
+        checksum *= 16777619u;
+    }
+    return checksum;
+}
+
+//Mixes a 4 byte value into a hash a whole word at a time, using the steps of MurmurHash3. This is much faster
+//than addToChecksum(), for hashes that are updated every time something changes.
+template <typename T>
+unsigned int addToHash(unsigned int hash, T value){
+    static_assert(sizeof(T) == 4, "addToHash() only mixes in 4 byte values");
+    unsigned int word;
+    memcpy(&word, &value, 4);
+
+    word *= 0xcc9e2d51u;
+    word = (word << 15) | (word >> 17);
+    word *= 0x1b873593u;
+
+    hash ^= word;
+    hash = (hash << 13) | (hash >> 19);
+    return hash*5 + 0xe6546b64u;
+}
+
+//Spreads every bit of a hash across the whole value, so that hashes can be added together without their bits clashing
+inline unsigned int finishHash(unsigned int hash){
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+#endif
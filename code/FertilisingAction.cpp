@@ -21,8 +21,34 @@ void FertilisingAction::reverseAction(){
     WateringAction::reverseAction();
 };
 
+void FertilisingAction::redoAction(){
+    //Fertilising is deterministic, so it is simply performed again
+    performAction();
+}
+
 void FertilisingAction::printData(){
     cout << "Fertilising action object" << endl;
     cout << "Nutrients added: " << nutrientsAdded << endl;
     cout << "Nutrients absorbed: " << nutrientsAbsorbed << endl;
 }
+
+ActionType FertilisingAction::getType(){
+    return FERTILISE_ACTION;
+}
+
+float FertilisingAction::getCommandAmount(){
+    return nutrientsAdded;
+}
+
+void FertilisingAction::writeToJournal(ostream& journal){
+    //Writes the water data before the nutrient data
+    WateringAction::writeToJournal(journal);
+    writeValue(journal, nutrientsAdded);
+    writeValue(journal, nutrientsAbsorbed);
+}
+
+void FertilisingAction::readFromJournal(istream& journal){
+    WateringAction::readFromJournal(journal);
+    nutrientsAdded = readValue<float>(journal);
+    nutrientsAbsorbed = readValue<float>(journal);
+}
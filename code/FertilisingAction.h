@@ -12,8 +12,14 @@ public:
     
     bool performAction();
     void reverseAction();
+    void redoAction();
     void printData();
 
+    ActionType getType();
+    float getCommandAmount();
+    void writeToJournal(ostream& journal);
+    void readFromJournal(istream& journal);
+
 private:
     float nutrientsAdded;
     float nutrientsAbsorbed;
@@ -0,0 +1,104 @@
+#include "Forest.h"
+#include <cmath>
+#include <climits>
+
+Forest::Forest(int numThreads) : pool(numThreads), generation(0) {};
+
+Forest::~Forest(){
+    for(int i = 0; i < trees.size(); i++){
+        delete trees[i].tree;
+    }
+}
+
+void Forest::addTree(unsigned int seed, int numBranches, float waterPerGeneration, float nutrientsPerGeneration,
+    const GrowthConfig& config){
+    Tree* tree = buildBinaryTree(numBranches, seed);
+    tree->setGrowthConfig(config);
+    trees.push_back({tree, waterPerGeneration, nutrientsPerGeneration, tree->getNumBranches(), tree->getTotalArea(),
+        tree->getStateHash()});
+}
+
+GenerationStats Forest::growGeneration(){
+    pool.run(trees.size(), [this](int position){ growTree(trees[position]); });
+    generation++;
+
+    //The totals are added up after every tree has grown, so the threads never share anything but their queues
+    GenerationStats stats = {generation, (int)trees.size(), 0, INT_MAX, 0, 0, 0, CHECKSUM_START};
+    for(int i = 0; i < trees.size(); i++){
+        stats.stateHash = addToHash(stats.stateHash, trees[i].stateHash);
+        stats.totalBranches += trees[i].numBranches;
+        stats.minBranches = min(stats.minBranches, trees[i].numBranches);
+        stats.maxBranches = max(stats.maxBranches, trees[i].numBranches);
+
+        if(isfinite(trees[i].totalArea) && trees[i].totalArea > 0){
+            stats.totalArea += trees[i].totalArea;
+        }else{
+            stats.numWithered++;
+        }
+    }
+    if(trees.empty()){
+        stats.minBranches = 0;
+    }
+    stats.stateHash = finishHash(stats.stateHash);
+
+    return stats;
+}
+
+int Forest::getNumTrees(){
+    return trees.size();
+}
+
+int Forest::getNumThreads(){
+    return pool.getNumThreads();
+}
+
+long long Forest::getNumStolen(){
+    return pool.getNumStolen();
+}
+
+const Tree* Forest::getTree(int position){
+    return trees[position].tree;
+}
+
+void Forest::growTree(ForestTree& forestTree){
+    //Withered trees stay as they are
+    if(!isfinite(forestTree.totalArea) || forestTree.totalArea <= 0){
+        return;
+    }
+
+    //The tree is grown directly rather than through actions, as there is no player and nothing to undo
+    float waterConsumed;
+    float nutrientsConsumed;
+    vector<float> widthIncreases;
+    vector<float> lengthIncreases;
+    vector<int> branchesGrown;
+    forestTree.tree->addWater(forestTree.waterPerGeneration);
+    forestTree.tree->addNutrients(forestTree.nutrientsPerGeneration);
+    forestTree.tree->grow(waterConsumed, nutrientsConsumed, widthIncreases, lengthIncreases, branchesGrown);
+
+    forestTree.numBranches = forestTree.tree->getNumBranches();
+    forestTree.totalArea = forestTree.tree->getTotalArea();
+    forestTree.stateHash = forestTree.tree->getStateHash();
+}
+
+Tree* buildBinaryTree(int numBranches, unsigned int seed){
+    vector<Branch> branches;
+    for(int i = 1; i < numBranches; i++){
+        Branch branch(i, (i-1)/2, 30*(i%3)-30, 50, 10, 0, 0);
+        for(int child = 2*i+1; child <= 2*i+2 && child < numBranches; child++){
+            branch.addChild(child);
+        }
+        branches.push_back(branch);
+    }
+
+    Branch* trunk = new Branch(0, 0, 1, 50, 10, 400, 500);
+    for(int child = 1; child <= 2 && child < numBranches; child++){
+        trunk->addChild(child);
+    }
+
+    Tree* tree = new Tree(10, 10, trunk, seed);
+    tree->addBranches(branches);
+    tree->updateBranchPos();
+    tree->updateMaxConstraints();
+    return tree;
+}
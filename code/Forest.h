@@ -0,0 +1,73 @@
+#ifndef FOREST_H
+#define FOREST_H
+
+#include <vector>
+#include "Tree.h"
+#include "WorkStealingPool.h"
+
+using namespace std;
+
+//Totals for every tree in a forest after one generation
+struct GenerationStats {
+    int generation;
+    int numTrees;
+    long long totalBranches;
+    int minBranches;
+    int maxBranches;
+    //Total area of the trees that are still growing
+    double totalArea;
+    //Trees whose branches have shrunk away to nothing after running out of water or nutrients
+    int numWithered;
+    //Combined state hash of every tree in the order they were added, which is the same for any number of threads
+    unsigned int stateHash;
+};
+
+//Grows a population of independent trees, each with its own seed and supply of water and nutrients.
+//Every generation grows all of the trees in parallel. Some seeds branch far more than others, so the trees are
+//shared between the threads with work stealing.
+class Forest {
+    public:
+        Forest(int numThreads);
+        ~Forest();
+
+        //Adds a tree of the given number of branches, which is given the water and nutrients before every generation
+        void addTree(unsigned int seed, int numBranches, float waterPerGeneration, float nutrientsPerGeneration,
+            const GrowthConfig& config = GrowthConfig());
+
+        //Waters and grows every tree once, returning the totals for the whole forest
+        GenerationStats growGeneration();
+
+        int getNumTrees();
+        int getNumThreads();
+
+        //Returns the number of trees grown by a different thread from the one they were given to
+        long long getNumStolen();
+
+        //Returns the tree that was added in the given position
+        const Tree* getTree(int position);
+
+    private:
+        struct ForestTree {
+            Tree* tree;
+            float waterPerGeneration;
+            float nutrientsPerGeneration;
+
+            //Results of the last generation, which are only written by the thread that grew the tree
+            int numBranches;
+            float totalArea;
+            unsigned int stateHash;
+        };
+
+        //Grows one tree, which runs on one of the pool's threads
+        void growTree(ForestTree& forestTree);
+
+        vector<ForestTree> trees;
+        WorkStealingPool pool;
+        int generation;
+};
+
+//Builds a tree where every branch has two children, until it has the given number of branches.
+//The trunk starts at the bottom middle of the game window and is its own parent, as in a new game.
+Tree* buildBinaryTree(int numBranches, unsigned int seed);
+
+#endif
@@ -1,13 +1,15 @@
 #include "Game.h"
 #include <fstream> // For std::ofstream
-#include "include/nlohmann/json.hpp" // For JSON serialization
+#include <cstring>
+#include <ctime>
+#include <memory>
 
 //Sets static variables
 int Game::mouseXPos = 0;
 int Game::mouseYPos = 0;
 bool Game::mouseClicked = false;
 
-Game::Game(int windowWidth, int windowHeight) : currentState(MAIN_MENU){
+Game::Game(int windowWidth, int windowHeight) : currentState(MAIN_MENU), currentSlot(-1), saveSlotPage(0){
     WINDOW_WIDTH = windowWidth;
     WINDOW_HEIGHT = windowHeight;
 
@@ -21,8 +23,15 @@ Game::Game(int windowWidth, int windowHeight) : currentState(MAIN_MENU){
     //Creates the image to display to the screen
     screenImg = new Mat(WINDOW_HEIGHT, WINDOW_WIDTH, CV_8UC3, CV_RGB(150, 150, 255));
 
-    //Creates the timeline
-    gameTimeline = new Timeline();
+    //Creates the timeline, which takes checkpoints of the tree and player
+    gameTimeline = nullptr;
+    resetTimeline(true);
+    startAutosave();
+
+    gameSaver = new BackgroundSaver();
+
+    //From now on the game state is only changed by commands that run on the simulation thread
+    simulation = new SimulationThread([this]() { return takeSnapshot(); });
 
     int buttonWidth = 250;
 
@@ -54,6 +63,15 @@ Game::Game(int windowWidth, int windowHeight) : currentState(MAIN_MENU){
     Rect reverseActionRect(WINDOW_WIDTH-buttonWidth, 400, buttonWidth, 100);
     buttonList.push_back(new Clickable(reverseActionRect, 9, "Reverse action"));
 
+    Rect timeTravelRect(10, 120, 200, 100);
+    buttonList.push_back(new Clickable(timeTravelRect, 12, "Time travel"));
+
+    Rect redoActionRect(10, 230, 200, 100);
+    buttonList.push_back(new Clickable(redoActionRect, 13, "Redo action"));
+
+    Rect switchTimelineRect(220, 10, buttonWidth, 100);
+    buttonList.push_back(new Clickable(switchTimelineRect, 14, "Switch timeline"));
+
     // Instantiate Save Game button
     Rect saveGameButtonRect(WINDOW_WIDTH-buttonWidth, 500, buttonWidth, 100); // Placed below "Reverse action"
     saveGameButton = new Clickable(saveGameButtonRect, 10, "Save Game");
@@ -62,14 +80,20 @@ Game::Game(int windowWidth, int windowHeight) : currentState(MAIN_MENU){
     Rect loadGameButtonRect(WINDOW_WIDTH/2-100, WINDOW_HEIGHT/2+170, 200, 100); // Below "Instructions"
     loadGameButton = new Clickable(loadGameButtonRect, 11, "Load Game");
 
+    Rect nextSlotPageRect(220, 10, 200, 100);
+    nextSlotPageButton = new Clickable(nextSlotPageRect, 15, "More saves");
+
+    Rect exportVideoRect(10, 340, 200, 100);
+    exportVideoButton = new Clickable(exportVideoRect, 16, "Export video");
+
     namedWindow("Time Travel Tree", 0);
 
     //Sets the mouse callback function
     setMouseCallback("Time Travel Tree", Game::handleMouseClick);
 
     //Tells the user how many supplies they have
-    cout << "You have " << gamePlayer->getWaterSupply() << "L of water" << endl;
-    cout << "You have " << gamePlayer->getFertiliserSupply() << "kg of fertiliser" << endl;
+    cout << "You have " << simulation->getSnapshot()->waterSupply << "L of water" << endl;
+    cout << "You have " << simulation->getSnapshot()->fertiliserSupply << "kg of fertiliser" << endl;
 
 }
 
@@ -79,6 +103,10 @@ Game::~Game(){
         delete buttonList[i];
     }
 
+    //Finishes the commands that are waiting, which may start a save, and then the save in progress before the state is freed
+    delete simulation;
+    delete gameSaver;
+
     //Frees memory
     delete screenImg;
     delete gameTree;
@@ -86,6 +114,8 @@ Game::~Game(){
     delete gameTimeline;
     delete saveGameButton; // Free Save Game button
     delete loadGameButton; // Free Load Game button
+    delete nextSlotPageButton;
+    delete exportVideoButton;
 
 }
 
@@ -125,6 +155,14 @@ void Game::drawScreen(){
             loadGameButton->draw(screenImg);
         }
         break;
+    case LOAD_MENU:
+        //Draws the back button
+        buttonList[2]->draw(screenImg);
+        if (saveSlots.size() > SAVE_SLOTS_PER_PAGE) {
+            nextSlotPageButton->draw(screenImg);
+        }
+        drawSaveSlots();
+        break;
     case INSTRUCTION_MENU:
         //Draws the back button
         buttonList[2]->draw(screenImg);
@@ -163,9 +201,21 @@ void Game::drawScreen(){
         if (saveGameButton) { // Ensure it's initialized
              saveGameButton->draw(screenImg);
         }
+        exportVideoButton->draw(screenImg);
+
+        //Draws the newest snapshot of the tree, which never waits for a growth step that is still running
+        const RenderSnapshot* snapshot = simulation->getSnapshot();
+        snapshot->tree.draw(screenImg);
+
+        string supplies = "Water: " + to_string((int)snapshot->waterSupply) + "L  Fertiliser: " +
+            to_string((int)snapshot->fertiliserSupply) + "kg  Step: " + to_string(snapshot->currentStep);
+        if (simulation->isBusy()) {
+            supplies += "  Growing...";
+        }
+        putText(*screenImg, supplies, Point(220, WINDOW_HEIGHT-50), FONT_HERSHEY_SIMPLEX, 0.6, Scalar(0, 0, 0), 2);
 
-        //Draws the tree to the screen
-        gameTree->draw(screenImg);
+        //Shows whether the last save has finished
+        putText(*screenImg, gameSaver->getStatus(), Point(220, WINDOW_HEIGHT-20), FONT_HERSHEY_SIMPLEX, 0.7, Scalar(0, 0, 0), 2);
 
         break;
     }
@@ -194,7 +244,8 @@ void Game::handleInputs(){
     }
 
     Point mousePos(Game::mouseXPos, Game::mouseYPos);
-    int prunedIndex = gameTree->getClickedIndex(mousePos.x, mousePos.y);
+    const RenderSnapshot* snapshot = simulation->getSnapshot();
+    int prunedIndex = snapshot->tree.getClickedIndex(mousePos.x, mousePos.y);
 
     //Checks if any buttons are being pressed
     switch(currentState) {
@@ -205,11 +256,38 @@ void Game::handleInputs(){
         } else if(buttonList[1]->contains(mousePos)){ // Instructions button
             currentState = INSTRUCTION_MENU;
         } else if (loadGameButton && loadGameButton->contains(mousePos)) { // Load Game button
-            loadGame();
-            // mouseClicked = false; // Optional: prevent other actions on same click
+            openLoadMenu();
         }
         
 
+    break;
+    case LOAD_MENU:
+        if(buttonList[2]->contains(mousePos)){
+            //Goes back to main menu
+            currentState = MAIN_MENU;
+        } else if (saveSlots.size() > SAVE_SLOTS_PER_PAGE && nextSlotPageButton->contains(mousePos)) {
+            //Moves to the next page, going back to the first page after the last
+            int numPages = (saveSlots.size() + SAVE_SLOTS_PER_PAGE - 1) / SAVE_SLOTS_PER_PAGE;
+            saveSlotPage = (saveSlotPage + 1) % numPages;
+        } else {
+            //Only the save of the slot that was clicked is opened
+            int firstSlot = saveSlotPage*SAVE_SLOTS_PER_PAGE;
+            for (int i = firstSlot; i < saveSlots.size() && i < firstSlot+SAVE_SLOTS_PER_PAGE; i++) {
+                if (getSaveSlotRect(i - firstSlot).contains(mousePos)) {
+                    int slot = saveSlots[i].slot;
+                    bool loaded = false;
+                    simulation->runAndWait([this, slot, &loaded]() { loaded = loadGame(slot); });
+
+                    // The menu state belongs to this thread, so it only changes once the load has finished
+                    if (loaded) {
+                        currentSlot = slot;
+                        currentState = IN_GAME;
+                    }
+                    break;
+                }
+            }
+        }
+
     break;
     case INSTRUCTION_MENU:
         if(buttonList[2]->contains(mousePos)){
@@ -226,12 +304,16 @@ void Game::handleInputs(){
         }
         else if(prunedIndex != -1){
             //Prunes a branch and returns to the regular game state
-            gameTimeline->performAction(new PruningAction(gameTree, prunedIndex));
+            simulation->submit([this, prunedIndex]() {
+                gameTimeline->performAction(PruningAction(gameTree, prunedIndex));
+            });
 
             currentState = IN_GAME;
         } else if (saveGameButton && saveGameButton->contains(mousePos)) {
             saveGame();
             // mouseClicked = false; // Optional: prevent other actions on same click
+        } else if (exportVideoButton->contains(mousePos)) {
+            exportVideo();
         }
 
     break;
@@ -250,7 +332,9 @@ void Game::handleInputs(){
             cout << "Enter the amount of water you want to add to the tree" << endl;
             cin >> waterAmount;
 
-            gameTimeline->performAction(new WateringAction(gamePlayer, gameTree, waterAmount));
+            simulation->submit([this, waterAmount]() {
+                gameTimeline->performAction(WateringAction(gamePlayer, gameTree, waterAmount));
+            });
         //Add fertiliser button pressed
         }else if (buttonList[5]->contains(mousePos)){
             float fertiliserAmount;
@@ -258,17 +342,45 @@ void Game::handleInputs(){
             cout << "Enter the amount of fertiliser you want to add to the tree" << endl;
             cin >> fertiliserAmount;
 
-            gameTimeline->performAction(new FertilisingAction(gamePlayer, gameTree, fertiliserAmount));
+            simulation->submit([this, fertiliserAmount]() {
+                gameTimeline->performAction(FertilisingAction(gamePlayer, gameTree, fertiliserAmount));
+            });
         //Prune branch button pressed
         }else if (buttonList[6]->contains(mousePos)){
             currentState = PRUNING_ACTION;
         //Grow button pressed
         }else if (buttonList[7]->contains(mousePos)){
-            gameTimeline->performAction(new GrowingAction(gamePlayer, gameTree));
+            //Growing a large tree is slow, so it runs while the game keeps drawing the last snapshot
+            simulation->submit([this]() {
+                gameTimeline->performAction(GrowingAction(gamePlayer, gameTree));
+            });
         }
         //Reverse action button pressed
         else if(buttonList[8]->contains(mousePos)){
-            gameTimeline->reverseAction();
+            simulation->submit([this]() { gameTimeline->reverseAction(); });
+        }
+        //Time travel button pressed
+        else if(buttonList[9]->contains(mousePos)){
+            int step;
+
+            cout << "Enter the step to travel to (currently at step " << snapshot->currentStep << ")" << endl;
+            cin >> step;
+
+            simulation->submit([this, step]() { gameTimeline->travelTo(step); });
+        }
+        //Redo action button pressed
+        else if(buttonList[10]->contains(mousePos)){
+            simulation->submit([this]() { gameTimeline->redoAction(); });
+        }
+        //Switch timeline button pressed
+        else if(buttonList[11]->contains(mousePos)){
+            int timelineNumber;
+
+            simulation->runAndWait([this]() { gameTimeline->printTimelines(); });
+            cout << "Enter the number of the timeline to switch to" << endl;
+            cin >> timelineNumber;
+
+            simulation->submit([this, timelineNumber]() { gameTimeline->switchTimeline(timelineNumber); });
         }
 
 
@@ -282,9 +394,11 @@ void Game::handleInputs(){
 
 void Game::printData(){
     cout << "Game object" << endl;
-    gameTree->printData();
-    gamePlayer->printData();
-    gameTimeline->printData();
+    simulation->runAndWait([this]() {
+        gameTree->printData();
+        gamePlayer->printData();
+        gameTimeline->printData();
+    });
 
     cout << "Window width: " << WINDOW_WIDTH << endl;
     cout << "Window height: " << WINDOW_HEIGHT << endl;
@@ -292,121 +406,215 @@ void Game::printData(){
     cout << "Game state: " << currentState << endl;
 }
 
-void Game::saveGame() {
-    nlohmann::json saveData;
+void Game::resetTimeline(bool recoverAutosave){
+    delete gameTimeline;
 
-    // Serialize gameTree
-    if (gameTree) {
-        saveData["tree"] = gameTree->toJson();
-    }
+    gameTimeline = new Timeline(gameTree, gamePlayer);
+    gameTimeline->setMemoryBudget(TIMELINE_MEMORY_BUDGET);
 
-    // Serialize gamePlayer
-    if (gamePlayer) {
-        saveData["player"] = gamePlayer->toJson();
+    if (AUTOSAVE && recoverAutosave && gameTimeline->recoverAutosave(AUTOSAVE_SNAPSHOT_PATH, AUTOSAVE_JOURNAL_PATH)) {
+        std::cout << "Continuing the autosaved game" << std::endl;
     }
-    
-    // Potentially save other relevant game state if any
-    // saveData["gameState"] = static_cast<int>(currentState); // Example if you want to save current game state enum
-
-    std::ofstream file("savegame.json");
-    if (file.is_open()) {
-        // Using dump(4) for pretty-printing JSON with an indent of 4 spaces
-        file << saveData.dump(4); 
-        file.close();
-        std::cout << "Game saved to savegame.json" << std::endl;
-        // Optionally provide visual feedback to the user on screen here
-    } else {
-        std::cerr << "Error: Could not open savegame.json for writing." << std::endl;
-        // Optionally provide visual error feedback to the user on screen here
+}
+
+void Game::startAutosave(){
+    if (AUTOSAVE) {
+        gameTimeline->enableAutosave(AUTOSAVE_SNAPSHOT_PATH, AUTOSAVE_JOURNAL_PATH);
     }
 }
 
-void Game::loadGame() {
-    std::ifstream file("savegame.json");
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open savegame.json for reading. Starting new game." << std::endl;
-        // Optional: Display this message on screen instead of console
-        // Creating a new default game session or letting user click "Play"
-        // For now, we just return and let the user decide next action (e.g. click Play for new game)
+void Game::saveGame() {
+    if (gameSaver->isSaving()) {
+        std::cerr << "Error: The last save has not finished yet." << std::endl;
         return;
     }
 
-    nlohmann::json saveData;
-    try {
-        file >> saveData;
-    } catch (nlohmann::json::parse_error& e) {
-        std::cerr << "Error: Could not parse savegame.json: " << e.what() << std::endl;
-        file.close();
-        // Optional: Display this message on screen
+    int slot;
+    std::cout << "Enter the number of the slot to save to";
+    if (currentSlot != -1) {
+        std::cout << " (this game is in slot " << currentSlot << ")";
+    }
+    std::cout << std::endl;
+    std::cin >> slot;
+    if (slot < 0) {
+        std::cerr << "Error: Save slots are numbered from 0." << std::endl;
         return;
     }
-    file.close();
 
-    // Clear existing game objects before loading
-    delete gameTree;
-    gameTree = nullptr; // Set to nullptr after delete to avoid dangling pointer issues
-    delete gamePlayer;
-    gamePlayer = nullptr;
-    delete gameTimeline; 
-    gameTimeline = new Timeline(); // Reset timeline
-
-    bool treeLoaded = false;
-    // Deserialize and reconstruct gameTree
-    if (saveData.contains("tree")) {
-        gameTree = Tree::fromJson(saveData["tree"]);
-        if (!gameTree) {
-            std::cerr << "Error: Failed to load tree data from savefile. Corrupted or invalid data." << std::endl;
-            // gameTree is already nullptr
-        } else {
-            treeLoaded = true;
+    // The slot index gets the last frame that was drawn, shrunk to a thumbnail
+    Mat thumbnail;
+    resize(*screenImg, thumbnail, Size(SAVE_THUMBNAIL_WIDTH, SAVE_THUMBNAIL_HEIGHT), 0, 0, INTER_AREA);
+
+    // The copies are taken on the simulation thread after the commands already given, so the save includes them.
+    // Copies of the tree and player take constant time, so the simulation only pauses for the timeline commands.
+    bool saveStarted = false;
+    simulation->runAndWait([&]() {
+        // The positions are worked out before the copy, which is saved on another thread
+        gameTree->resolvePositions();
+        Tree* treeCopy = new Tree(*gameTree);
+        Player* playerCopy = new Player(*gamePlayer);
+        TimelineSave* timelineCopy = nullptr;
+
+        string path = getSaveSlotPath(slot, ".bin");
+        if (!BINARY_SAVES) {
+            path = getSaveSlotPath(slot, ".json");
+            if (COMPACT_SAVES && gameTimeline) {
+                // Stores the start state and commands, with a checksum to verify the tree that replaying them rebuilds
+                timelineCopy = new TimelineSave(gameTimeline->getSave());
+            }
         }
+
+        SaveSlotInfo slotInfo = createSaveSlotInfo(slot, "Step " + to_string(gameTimeline->getCurrentStep()), gameTree);
+        memcpy(slotInfo.thumbnail, thumbnail.data, sizeof(slotInfo.thumbnail));
+
+        // The result is shown on screen once the save thread has finished, which also updates the index
+        saveStarted = gameSaver->startSave(treeCopy, playerCopy, timelineCopy, path, [slotInfo]() {
+            updateSaveSlotIndex(SAVE_SLOT_INDEX_PATH, slotInfo);
+        });
+    });
+
+    // A save that was refused is reported on screen by the saver, and the game stays in its old slot
+    if (saveStarted) {
+        currentSlot = slot;
+    }
+}
+
+void Game::exportVideo() {
+    string path;
+    std::cout << "Enter the file to export to, ending in .avi or .mp4 for a video or .png for numbered images" << std::endl;
+    std::cin >> path;
+
+    // Frames are encoded on another thread while the next ones are drawn, so only a few are in memory at once
+    // The save is copied on the simulation thread, as the tree and timeline can be changing until then
+    unique_ptr<TimelineSave> save;
+    simulation->runAndWait([this, &save]() { save.reset(new TimelineSave(gameTimeline->getSave())); });
+    std::cout << "Exporting " << save->commands.size()+1 << " frames to " << path << std::endl;
+    if (exportTimelapse(*save, path, WINDOW_WIDTH, WINDOW_HEIGHT)) {
+        std::cout << "Time-lapse exported to " << path << std::endl;
     } else {
-        std::cerr << "Error: Save data does not contain tree information." << std::endl;
+        std::cerr << "Error: Could not export the time-lapse to " << path << std::endl;
     }
+}
+
+RenderSnapshot Game::takeSnapshot() {
+    // The snapshot is drawn on the main thread, so its positions have to be worked out here first
+    gameTree->resolvePositions();
+    return {*gameTree, gamePlayer->getWaterSupply(), gamePlayer->getFertiliserSupply(), gameTimeline->getCurrentStep(),
+        gameTimeline->getNumTimelines()};
+}
+
+void Game::openLoadMenu() {
+    saveSlots = readSaveSlotIndex(SAVE_SLOT_INDEX_PATH);
+    saveSlotPage = 0;
+    currentState = LOAD_MENU;
+}
 
-    // If tree loading failed, reinitialize default tree
-    if (!treeLoaded) {
-        std::cout << "Starting new game with default tree." << std::endl;
-        gameTree = new Tree(10, 10, new Branch(0, 0, 1, 50, 10,  WINDOW_WIDTH/ 2, WINDOW_HEIGHT));
+Rect Game::getSaveSlotRect(int positionOnPage) {
+    // Slots are shown in three columns below the back button
+    int column = positionOnPage % 3;
+    int row = positionOnPage / 3;
+    return Rect(10 + column*262, 120 + row*90, 255, 85);
+}
+
+void Game::drawSaveSlots() {
+    if (saveSlots.empty()) {
+        putText(*screenImg, "There are no saved games", Point(WINDOW_WIDTH/2-150, WINDOW_HEIGHT/2), FONT_HERSHEY_SIMPLEX, 0.8, Scalar(0, 0, 0), 2);
+        return;
     }
 
-    bool playerLoaded = false;
-    // Deserialize and reconstruct gamePlayer
-    if (saveData.contains("player")) {
-        // Player::fromJson returns a Player object by value, so we construct a new Player on the heap
-        gamePlayer = new Player(Player::fromJson(saveData["player"]));
-        playerLoaded = true;
-    } else {
-        std::cerr << "Error: Save data does not contain player information." << std::endl;
+    int firstSlot = saveSlotPage*SAVE_SLOTS_PER_PAGE;
+    for (int i = firstSlot; i < saveSlots.size() && i < firstSlot+SAVE_SLOTS_PER_PAGE; i++) {
+        SaveSlotInfo& slotInfo = saveSlots[i];
+        Rect slotRect = getSaveSlotRect(i - firstSlot);
+        rectangle(*screenImg, slotRect, CV_RGB(220, 220, 220), FILLED);
+        rectangle(*screenImg, slotRect, CV_RGB(150, 150, 150), 2);
+
+        // Draws the thumbnail at twice its size on the left of the slot
+        Mat thumbnail(SAVE_THUMBNAIL_HEIGHT, SAVE_THUMBNAIL_WIDTH, CV_8UC3, slotInfo.thumbnail);
+        Rect thumbnailRect(slotRect.x+5, slotRect.y+5, SAVE_THUMBNAIL_WIDTH*2, SAVE_THUMBNAIL_HEIGHT*2);
+        Mat enlargedThumbnail;
+        resize(thumbnail, enlargedThumbnail, thumbnailRect.size());
+        enlargedThumbnail.copyTo((*screenImg)(thumbnailRect));
+
+        char savedTime[32];
+        time_t timestamp = slotInfo.timestamp;
+        strftime(savedTime, sizeof(savedTime), "%d/%m/%Y %H:%M", localtime(&timestamp));
+
+        int textX = thumbnailRect.x + thumbnailRect.width + 8;
+        putText(*screenImg, "Slot " + to_string(slotInfo.slot) + ": " + slotInfo.name, Point(textX, slotRect.y+22), FONT_HERSHEY_SIMPLEX, 0.45, Scalar(0, 0, 0), 1);
+        putText(*screenImg, to_string(slotInfo.numBranches) + " branches", Point(textX, slotRect.y+42), FONT_HERSHEY_SIMPLEX, 0.4, Scalar(0, 0, 0), 1);
+        putText(*screenImg, "Area " + to_string((int)slotInfo.totalArea), Point(textX, slotRect.y+60), FONT_HERSHEY_SIMPLEX, 0.4, Scalar(0, 0, 0), 1);
+        putText(*screenImg, savedTime, Point(textX, slotRect.y+78), FONT_HERSHEY_SIMPLEX, 0.4, Scalar(0, 0, 0), 1);
     }
-    
-    // If player loading failed, reinitialize default player
-    if (!playerLoaded) {
-        std::cout << "Using default player." << std::endl;
-        // Ensure gamePlayer is not leaked if it was partially allocated or something went wrong
-        delete gamePlayer; // delete if it was allocated by a failed fromJson or similar
-        gamePlayer = new Player(10, 5); // Default player
+}
+
+bool Game::loadGame(int slot) {
+    string path = getSaveSlotPath(slot, BINARY_SAVES ? ".bin" : ".json");
+    if (BINARY_SAVES) {
+        Tree* loadedTree;
+        Player* loadedPlayer;
+        if (!loadBinarySave(path, loadedTree, loadedPlayer)) {
+            std::cerr << "Error: Could not load " << path << ". Continuing the current game." << std::endl;
+            return false;
+        }
+
+        delete gameTree;
+        delete gamePlayer;
+        gameTree = loadedTree;
+        gamePlayer = loadedPlayer;
+        resetTimeline();
+        startAutosave();
+
+        std::cout << "Game loaded successfully from " << path << std::endl;
+        return true;
     }
-    
-    if (treeLoaded && playerLoaded) {
-        currentState = IN_GAME; // Transition to game after successful load
-        std::cout << "Game loaded successfully from savegame.json" << std::endl;
+
+    // Reads the save in a single pass, straight into the tree and player
+    JsonSave save;
+    if (!readJsonSave(path, save)) {
+        std::cerr << "Error: Could not load " << path << ". Continuing the current game." << std::endl;
+        return false;
+    }
+
+    // Compact saves store the start of the timeline, which is loaded in the same way as a full save
+    Tree* loadedTree;
+    Player* loadedPlayer;
+    if (save.timeline) {
+        loadedTree = new Tree(save.timeline->startTree);
+        loadedPlayer = new Player(save.timeline->startPlayer);
     } else {
-        std::cout << "Failed to load full game state. Some defaults may be used. Check errors above." << std::endl;
-        // Stay on MAIN_MENU or decide on a different state
-        // Forcing a new game state if critical parts failed
-        if (!treeLoaded) { // If tree is critical and failed to load, don't go IN_GAME
-             currentState = MAIN_MENU; // Stay on main menu
-             // Re-init default tree and player if not already done by error handling above
-             delete gameTree;
-             gameTree = new Tree(10, 10, new Branch(0, 0, 1, 50, 10,  WINDOW_WIDTH/ 2, WINDOW_HEIGHT));
-             delete gamePlayer;
-             gamePlayer = new Player(10, 5);
-             std::cout << "Critical load failure. Resetting to new game state." << std::endl;
-        } else {
-            // If only player failed, we might still proceed or handle differently.
-            // For now, if either critical part (tree) fails, it's not a successful load to IN_GAME.
-            currentState = MAIN_MENU; // Or specific error state
+        loadedTree = save.tree.release();
+        loadedPlayer = save.player.release();
+    }
+
+    //Rebuilds the saved game by performing every saved action again, which also rebuilds the timeline.
+    //This is done before the current game is replaced, so it carries on if the replay does not match the save.
+    Timeline* loadedTimeline = new Timeline(loadedTree, loadedPlayer);
+    if (save.timeline) {
+        loadedTimeline->replayCommands(save.timeline->commands);
+
+        if (save.hasChecksum && save.checksum != loadedTree->getChecksum()) {
+            std::cerr << "Error: " << path << " replayed to a different tree than the one that was saved. Continuing the current game." << std::endl;
+            delete loadedTimeline;
+            delete loadedTree;
+            delete loadedPlayer;
+            return false;
         }
     }
+
+    delete gameTimeline;
+    delete gameTree;
+    delete gamePlayer;
+    gameTree = loadedTree;
+    gamePlayer = loadedPlayer;
+    gameTimeline = loadedTimeline;
+
+    //The journal is only used once the old timeline has deleted its own, as they use the same file
+    gameTimeline->setMemoryBudget(TIMELINE_MEMORY_BUDGET);
+
+    //Autosave starts after the replay, so the replayed actions are written once in a single snapshot
+    startAutosave();
+
+    std::cout << "Game loaded successfully from " << path << std::endl;
+    return true;
 }
\ No newline at end of file
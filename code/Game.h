@@ -3,6 +3,11 @@
 
 #include "Printable.h"
 #include "Timeline.h"
+#include "SaveFormat.h"
+#include "BackgroundSaver.h"
+#include "SaveSlots.h"
+#include "TimelapseExporter.h"
+#include "SimulationThread.h"
 #include "Tree.h"
 #include "Clickable.h"
 #include "Player.h"
@@ -18,11 +23,25 @@ namespace nlohmann {
 
 using namespace cv;
 
+//Number of actions the timeline keeps in memory before moving older ones to its journal file
+const int TIMELINE_MEMORY_BUDGET = 200;
+//Saves the starting state and the list of actions instead of the whole tree, which is rebuilt by replaying them
+const bool COMPACT_SAVES = true;
+//Saves the whole state in the binary format from SaveFormat.h, which loads much faster than JSON but has no timeline
+const bool BINARY_SAVES = false;
+//Keeps a journal of every action so the last game can be continued, even if it was closed without saving
+const bool AUTOSAVE = true;
+const string AUTOSAVE_SNAPSHOT_PATH = "autosave.json";
+const string AUTOSAVE_JOURNAL_PATH = "autosave.journal";
+//Number of save slots shown on each page of the load menu
+const int SAVE_SLOTS_PER_PAGE = 12;
+
 enum GameState{
     MAIN_MENU,
     INSTRUCTION_MENU,
     IN_GAME,
-    PRUNING_ACTION
+    PRUNING_ACTION,
+    LOAD_MENU
 };
 
 class Game : Printable{
@@ -47,9 +66,15 @@ class Game : Printable{
     private:
         Mat* screenImg;
 
+        //The game state is only changed on the simulation thread once it has started, by giving it commands.
+        //Drawing uses the snapshots that it publishes instead.
         Tree* gameTree;
         Player* gamePlayer;
         Timeline* gameTimeline;
+        SimulationThread* simulation;
+
+        //Writes saves while the game keeps running
+        BackgroundSaver* gameSaver;
 
         vector<Clickable*> buttonList;
 
@@ -60,9 +85,40 @@ class Game : Printable{
 
         Clickable* saveGameButton; // Save Game button
         Clickable* loadGameButton; // Load Game button
+        Clickable* nextSlotPageButton; // Shows the next page of the load menu
+        Clickable* exportVideoButton; // Exports the current timeline as a time-lapse
+
+        //The slot that the game was last saved to or loaded from, or -1 if there is none
+        int currentSlot;
+
+        //The slots listed in the load menu, which are read from the slot index when the menu is opened
+        vector<SaveSlotInfo> saveSlots;
+        int saveSlotPage;
+
+        //Replaces the timeline with an empty one that tracks the current tree and player.
+        //The autosaved game is recovered first if requested.
+        void resetTimeline(bool recoverAutosave = false);
+
+        //Starts autosaving the timeline, which writes a snapshot of the whole timeline straight away
+        void startAutosave();
+
+        //Copies everything that is drawn from the game state, which runs on the simulation thread
+        RenderSnapshot takeSnapshot();
+
+        void saveGame(); // Starts saving the game state to a slot in the background
+        bool loadGame(int slot); // Loads the game state from a slot on the simulation thread, returning false if it could not be loaded
+
+        //Replays the current timeline from its start and exports every step as a time-lapse
+        void exportVideo();
+
+        //Lists the saved games by reading only the slot index
+        void openLoadMenu();
+
+        //Returns the area of the load menu that shows a slot, given its position on the page
+        Rect getSaveSlotRect(int positionOnPage);
 
-        void saveGame(); // Method to save the game state
-        void loadGame(); // Method to load the game state
+        //Draws the thumbnail and details of each slot on the current page of the load menu
+        void drawSaveSlots();
 };
 
 
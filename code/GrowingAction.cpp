@@ -3,12 +3,24 @@
 GrowingAction::GrowingAction(Player* currentPlayer, Tree* currentTree) : treeToModify(currentTree), playerToModify(currentPlayer) {};
 
 bool GrowingAction::performAction() {
+    randomStateBefore = treeToModify->getRandomState();
+
     //Grows the tree and stores the changes in the corrresponding variables
     treeToModify->grow(waterConsumed, nutrientsConsumed, 
     branchWidthIncreases, branchLengthIncreases, newBranchIndices);
 
-    playerToModify->addFertiliser(1);
-    playerToModify->addWater(2);
+    //Records the new branches
+    newBranches.clear();
+    for(int i = 0; i < newBranchIndices.size(); i++){
+        newBranches.push_back(*treeToModify->getBranch(newBranchIndices[i]));
+    }
+    randomStateAfter = treeToModify->getRandomState();
+
+    //Gives the player some free supplies for growing
+    fertiliserGiven = 1;
+    waterGiven = 2;
+    playerToModify->addFertiliser(fertiliserGiven);
+    playerToModify->addWater(waterGiven);
 
     return true;
 };
@@ -21,9 +33,26 @@ void GrowingAction::reverseAction() {
     //Returns water and nutrients to the tree
     treeToModify->addWater(waterConsumed);
     treeToModify->addNutrients(nutrientsConsumed);
-    
+    treeToModify->setRandomState(randomStateBefore);
+    //Takes back the free supplies given to the player, or as much of them as the player has left,
+    //and remembers how much was taken so that a redo gives back the same amount
+    fertiliserGiven = min(fertiliserGiven, playerToModify->getFertiliserSupply());
+    waterGiven = min(waterGiven, playerToModify->getWaterSupply());
+    playerToModify->useFertiliser(fertiliserGiven);
+    playerToModify->useWater(waterGiven);
 };
 
+void GrowingAction::redoAction() {
+    //Applies the recorded growth again rather than growing randomly
+    treeToModify->regrowBranches(branchWidthIncreases, branchLengthIncreases, newBranches);
+    treeToModify->removeWater(waterConsumed);
+    treeToModify->removeNutrients(nutrientsConsumed);
+    treeToModify->setRandomState(randomStateAfter);
+
+    playerToModify->addFertiliser(fertiliserGiven);
+    playerToModify->addWater(waterGiven);
+}
+
 void GrowingAction::printData() {
     cout << "Growing action object" << endl;
     cout << "Water conumed: " << waterConsumed << endl;
@@ -47,3 +76,44 @@ void GrowingAction::printData() {
     cout << endl;
 }
 
+ActionType GrowingAction::getType(){
+    return GROW_ACTION;
+}
+
+float GrowingAction::getCommandAmount(){
+    return 0;
+}
+
+void GrowingAction::writeToJournal(ostream& journal){
+    writeValue(journal, waterConsumed);
+    writeValue(journal, nutrientsConsumed);
+    writeVector(journal, branchWidthIncreases);
+    writeVector(journal, branchLengthIncreases);
+    writeVector(journal, newBranchIndices);
+    writeValue(journal, randomStateBefore);
+    writeValue(journal, randomStateAfter);
+    writeValue(journal, fertiliserGiven);
+    writeValue(journal, waterGiven);
+
+    for(int i = 0; i < newBranches.size(); i++){
+        newBranches[i].writeBinary(journal);
+    }
+}
+
+void GrowingAction::readFromJournal(istream& journal){
+    waterConsumed = readValue<float>(journal);
+    nutrientsConsumed = readValue<float>(journal);
+    branchWidthIncreases = readVector<float>(journal);
+    branchLengthIncreases = readVector<float>(journal);
+    newBranchIndices = readVector<int>(journal);
+    randomStateBefore = readValue<unsigned int>(journal);
+    randomStateAfter = readValue<unsigned int>(journal);
+    fertiliserGiven = readValue<float>(journal);
+    waterGiven = readValue<float>(journal);
+
+    //There is one new branch for each new branch index
+    newBranches.clear();
+    for(int i = 0; i < newBranchIndices.size(); i++){
+        newBranches.push_back(Branch::readBinary(journal));
+    }
+}
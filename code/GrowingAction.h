@@ -6,14 +6,20 @@
 #include "Tree.h"
 #include "Player.h"
 
-class GrowingAction : public Action, public Printable{
+class GrowingAction : public Printable{
     public:
         GrowingAction(Player* currentPlayer, Tree* currentTree);
 
         bool performAction();
         void reverseAction();
+        void redoAction();
         void printData();
 
+        ActionType getType();
+        float getCommandAmount();
+        void writeToJournal(ostream& journal);
+        void readFromJournal(istream& journal);
+
     private:
         Tree* treeToModify;
         Player* playerToModify;
@@ -27,6 +33,18 @@ class GrowingAction : public Action, public Printable{
 
         //Stores the indices of every new branch that was added
         vector<int> newBranchIndices;
+
+        //Copies of the new branches, so that a redo adds the same branches instead of growing randomly
+        vector<Branch> newBranches;
+
+        //The random state of the tree before and after growing, so later growth is the same after an undo or redo
+        unsigned int randomStateBefore;
+        unsigned int randomStateAfter;
+
+        //The free supplies that were given to the player, which is less than the full amount if the player had
+        //already used some of them when the growth was reversed
+        float fertiliserGiven;
+        float waterGiven;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef GROWTH_CONFIG_H
+#define GROWTH_CONFIG_H
+
+//The laws that can be used to split the growth of a branch between its width and length, from GrowthPolicy.h
+enum GrowthLaw {
+    QUADRATIC_GROWTH,
+    LINEAR_GROWTH,
+    LOGISTIC_GROWTH
+};
+
+//The ways that the water and nutrients used in each growth can be shared out between the branches
+enum SupplyModel {
+    EVEN_SUPPLY,
+    VASCULAR_SUPPLY
+};
+
+//The parameters of the growth model, which each tree has its own copy of.
+//The defaults are the values the game was balanced with.
+struct GrowthConfig {
+    //Maximum area of a branch before it will no longer sprout new branches
+    float newBranchThreshold = 5000;
+
+    //Required nutrients and water for a new branch to grow
+    float newBranchRequirement = 3;
+
+    //Scales the amount that branches grow by with a given amount of food
+    float branchGrowthAmount = 50;
+
+    //Chance of each existing branch growing a new branch
+    float newBranchProbability = 0.4;
+
+    //The change in length of a branch is this divided by its age times the change in width,
+    //so a larger value makes branches grow longer for more of their life before they grow wider
+    float lengthGrowthRatio = 20;
+
+    //Fraction of the water and nutrients that the tree can store which is used up every time it grows
+    float supplyUsedPerGrowth = 0.05;
+
+    //Area of branch needed to store one litre of water or one kilogram of nutrients
+    float areaPerSupply = 50;
+
+    //Number of random angles tried for a new branch before it is given up on, so that it does not overlap the
+    //branches already there. When this is 0, new branches grow at the first angle even if they overlap.
+    float sproutAttempts = 0;
+
+    //How the growth of each branch is split between its width and length. The tree is grown by a loop compiled for
+    //the chosen law, which is picked once per growth rather than once per branch.
+    GrowthLaw growthLaw = QUADRATIC_GROWTH;
+
+    //How the water and nutrients are shared between the branches. With even supply every branch gets the same amount.
+    //With vascular supply they flow out from the trunk, and each branch keeps a part in proportion to its width and
+    //passes the rest on to its children in proportion to theirs, so branches far from the trunk get less.
+    SupplyModel supplyModel = EVEN_SUPPLY;
+};
+
+#endif
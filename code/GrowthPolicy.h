@@ -0,0 +1,54 @@
+#ifndef GROWTH_POLICY_H
+#define GROWTH_POLICY_H
+
+#include <cmath>
+#include "GrowthConfig.h"
+
+//Growth policies decide how the area that a branch grows by is split between its width and its length.
+//Each one is a type with a static splitGrowth() function, which the growth loop is compiled for separately,
+//so the formula is inlined into the loop instead of being called through a pointer for every branch.
+
+//The change in length is n/age times the change in width, where n is the config's length growth ratio, so a branch
+//grows longer at first and then grows wider. The width is found with the quadratic formula, so the area grows by
+//exactly the given amount. This is the game's growth law.
+struct QuadraticGrowth {
+    static void splitGrowth(float width, float length, int age, float areaIncrease, const GrowthConfig& config,
+        float &widthIncrease, float &lengthIncrease){
+        float n = config.lengthGrowthRatio;
+
+        //(width + widthIncrease)*(length + lengthIncrease) = width*length + areaIncrease, solved for widthIncrease.
+        //The square is worked out in double precision, which gives exactly the same result as pow().
+        float scaledWidth = (n*width)/age+length;
+        widthIncrease = (-scaledWidth+sqrt((double)scaledWidth*scaledWidth+(4*n*areaIncrease)/age))/(2*n/age);
+
+        lengthIncrease = (n/age)*widthIncrease;
+    }
+};
+
+//Splits the growth in the same ratio as QuadraticGrowth, but ignores the small corner where the new width and new
+//length overlap, so there is no square root. Branches grow by slightly more than the given area.
+struct LinearGrowth {
+    static void splitGrowth(float width, float length, int age, float areaIncrease, const GrowthConfig& config,
+        float &widthIncrease, float &lengthIncrease){
+        float ratio = config.lengthGrowthRatio/age;
+        widthIncrease = areaIncrease/(length+ratio*width);
+        lengthIncrease = ratio*widthIncrease;
+    }
+};
+
+//Grows like QuadraticGrowth, but slows down as the branch gets close to a maximum area and stops once it reaches it
+template <int MaxArea = 20000>
+struct LogisticGrowth {
+    static constexpr float MAX_AREA = MaxArea;
+
+    static void splitGrowth(float width, float length, int age, float areaIncrease, const GrowthConfig& config,
+        float &widthIncrease, float &lengthIncrease){
+        float spaceLeft = 1-width*length/MAX_AREA;
+        if(spaceLeft < 0){
+            spaceLeft = 0;
+        }
+        QuadraticGrowth::splitGrowth(width, length, age, areaIncrease*spaceLeft, config, widthIncrease, lengthIncrease);
+    }
+};
+
+#endif
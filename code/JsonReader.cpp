@@ -0,0 +1,366 @@
+#include "JsonReader.h"
+#include <charconv>
+#include <cstring>
+#include <cctype>
+#include <cmath>
+#include <climits>
+#include <sstream>
+
+JsonReadError::JsonReadError(const string& message, int errorLine, int errorColumn) :
+    runtime_error(message + " at line " + to_string(errorLine) + ", column " + to_string(errorColumn)),
+    line(errorLine), column(errorColumn) {};
+
+JsonReader::JsonReader(const char* data, size_t size) : start(data), position(data), end(data + size) {};
+
+JsonReader::JsonReader(istream& stream){
+    //Reads the stream in one go if its size is known, otherwise it is copied through its buffer
+    stream.seekg(0, ios::end);
+    streamoff size = stream.tellg();
+    stream.seekg(0, ios::beg);
+    if(size >= 0){
+        ownedData.resize(size);
+        stream.read(&ownedData[0], size);
+        ownedData.resize(stream.gcount());
+    }else{
+        stream.clear();
+        ostringstream contents;
+        contents << stream.rdbuf();
+        ownedData = contents.str();
+    }
+
+    start = ownedData.data();
+    position = start;
+    end = start + ownedData.size();
+}
+
+void JsonReader::beginObject(){
+    expect('{', "an object");
+    if(hasValues.size() >= JSON_READER_MAX_DEPTH){
+        fail("objects and arrays are nested too deeply");
+    }
+    hasValues.push_back(false);
+}
+
+bool JsonReader::nextKey(string& name){
+    if(peek() == '}'){
+        position++;
+        hasValues.pop_back();
+        return false;
+    }
+
+    startElement("',' or '}'");
+    readString(name);
+    expect(':', "':' after the key");
+    return true;
+}
+
+void JsonReader::beginArray(){
+    expect('[', "an array");
+    if(hasValues.size() >= JSON_READER_MAX_DEPTH){
+        fail("objects and arrays are nested too deeply");
+    }
+    hasValues.push_back(false);
+}
+
+bool JsonReader::nextElement(){
+    if(peek() == ']'){
+        position++;
+        hasValues.pop_back();
+        return false;
+    }
+
+    startElement("',' or ']'");
+    return true;
+}
+
+float JsonReader::readFloat(){
+    //JsonWriter writes NaN and infinity as null, which are read back as NaN
+    if(peek() == 'n'){
+        expectWord("null");
+        return NAN;
+    }
+
+    const char* numberStart;
+    const char* numberEnd;
+    readNumber(numberStart, numberEnd);
+
+    //Parses the shortest text written by JsonWriter back into exactly the same float
+    float number;
+    from_chars_result result = from_chars(numberStart, numberEnd, number);
+    if(result.ec != errc() || result.ptr != numberEnd){
+        position = numberStart;
+        fail("invalid number");
+    }
+    return number;
+}
+
+int JsonReader::readInt(){
+    const char* numberStart;
+    const char* numberEnd;
+    readNumber(numberStart, numberEnd);
+
+    int number;
+    from_chars_result result = from_chars(numberStart, numberEnd, number);
+    if(result.ec == errc() && result.ptr == numberEnd){
+        return number;
+    }
+
+    //Accepts whole numbers written with a fraction or exponent, such as 2.0
+    double wholeNumber;
+    result = from_chars(numberStart, numberEnd, wholeNumber);
+    if(result.ec != errc() || result.ptr != numberEnd || floor(wholeNumber) != wholeNumber || wholeNumber < INT_MIN || wholeNumber > INT_MAX){
+        position = numberStart;
+        fail("expected an integer");
+    }
+    return (int)wholeNumber;
+}
+
+unsigned int JsonReader::readUnsigned(){
+    const char* numberStart;
+    const char* numberEnd;
+    readNumber(numberStart, numberEnd);
+
+    unsigned int number;
+    from_chars_result result = from_chars(numberStart, numberEnd, number);
+    if(result.ec == errc() && result.ptr == numberEnd){
+        return number;
+    }
+
+    double wholeNumber;
+    result = from_chars(numberStart, numberEnd, wholeNumber);
+    if(result.ec != errc() || result.ptr != numberEnd || floor(wholeNumber) != wholeNumber || wholeNumber < 0 || wholeNumber > UINT_MAX){
+        position = numberStart;
+        fail("expected an unsigned integer");
+    }
+    return (unsigned int)wholeNumber;
+}
+
+bool JsonReader::readBool(){
+    char next = peek();
+    if(next == 't'){
+        expectWord("true");
+        return true;
+    }
+    if(next == 'f'){
+        expectWord("false");
+        return false;
+    }
+    fail("expected true or false");
+}
+
+string JsonReader::readString(){
+    string text;
+    readString(text);
+    return text;
+}
+
+void JsonReader::skipValue(){
+    switch(peek()){
+    case '{':
+        beginObject();
+        while(nextKey(skippedText)){
+            skipValue();
+        }
+        break;
+    case '[':
+        beginArray();
+        while(nextElement()){
+            skipValue();
+        }
+        break;
+    case '"':
+        readString(skippedText);
+        break;
+    case 't':
+    case 'f':
+        readBool();
+        break;
+    case 'n':
+        expectWord("null");
+        break;
+    default:
+        readFloat();
+        break;
+    }
+}
+
+void JsonReader::endDocument(){
+    peek();
+    if(position < end){
+        fail("expected the end of the data");
+    }
+}
+
+void JsonReader::fail(const string& message){
+    //The line and column are only worked out when there is an error, so reading does not have to track them
+    int line = 1;
+    int column = 1;
+    for(const char* character = start; character < position && character < end; character++){
+        if(*character == '\n'){
+            line++;
+            column = 1;
+        }else{
+            column++;
+        }
+    }
+    throw JsonReadError(message, line, column);
+}
+
+char JsonReader::peek(){
+    while(position < end && (*position == ' ' || *position == '\n' || *position == '\r' || *position == '\t')){
+        position++;
+    }
+    return position < end ? *position : 0;
+}
+
+void JsonReader::expect(char character, const char* description){
+    if(peek() != character){
+        if(position == end){
+            fail(string("expected ") + description + " but the data ended");
+        }
+        fail(string("expected ") + description + " but found '" + *position + "'");
+    }
+    position++;
+}
+
+void JsonReader::expectWord(const char* word){
+    size_t length = strlen(word);
+    if(end - position < (long)length || memcmp(position, word, length) != 0){
+        fail(string("expected ") + word);
+    }
+    position += length;
+}
+
+void JsonReader::readNumber(const char*& numberStart, const char*& numberEnd){
+    peek();
+    numberStart = position;
+    while(position < end && (isdigit((unsigned char)*position) || *position == '-' || *position == '+' ||
+          *position == '.' || *position == 'e' || *position == 'E')){
+        position++;
+    }
+    numberEnd = position;
+
+    if(numberStart == numberEnd){
+        if(position == end){
+            fail("expected a number but the data ended");
+        }
+        fail(string("expected a value but found '") + *position + "'");
+    }
+}
+
+void JsonReader::readString(string& text){
+    expect('"', "a string");
+    text.clear();
+
+    while(true){
+        //Copies runs of plain characters at once, as most strings have no escapes
+        const char* runStart = position;
+        while(position < end && *position != '"' && *position != '\\' && (unsigned char)*position >= 0x20){
+            position++;
+        }
+        text.append(runStart, position);
+
+        if(position == end){
+            fail("the string is not closed");
+        }
+        if(*position == '"'){
+            position++;
+            return;
+        }
+        if(*position != '\\'){
+            fail("control characters in strings must be escaped");
+        }
+
+        position++;
+        if(position == end){
+            fail("the string is not closed");
+        }
+        switch(*position){
+        case '"': text += '"'; break;
+        case '\\': text += '\\'; break;
+        case '/': text += '/'; break;
+        case 'b': text += '\b'; break;
+        case 'f': text += '\f'; break;
+        case 'n': text += '\n'; break;
+        case 'r': text += '\r'; break;
+        case 't': text += '\t'; break;
+        case 'u':
+            position++;
+            readUnicodeEscape(text);
+            continue;
+        default:
+            fail(string("invalid escape '\\") + *position + "'");
+        }
+        position++;
+    }
+}
+
+//Reads four hex digits, returning -1 if they are not all hex digits
+static int readHexDigits(const char* digits, const char* end){
+    if(end - digits < 4){
+        return -1;
+    }
+
+    int value = 0;
+    for(int i = 0; i < 4; i++){
+        char digit = digits[i];
+        value *= 16;
+        if(digit >= '0' && digit <= '9'){
+            value += digit - '0';
+        }else if(digit >= 'a' && digit <= 'f'){
+            value += digit - 'a' + 10;
+        }else if(digit >= 'A' && digit <= 'F'){
+            value += digit - 'A' + 10;
+        }else{
+            return -1;
+        }
+    }
+    return value;
+}
+
+void JsonReader::readUnicodeEscape(string& text){
+    int codePoint = readHexDigits(position, end);
+    if(codePoint == -1){
+        fail("expected four hex digits after \\u");
+    }
+    position += 4;
+
+    //Characters outside the basic plane are written as two escapes, called a surrogate pair
+    if(codePoint >= 0xD800 && codePoint <= 0xDBFF){
+        int lowSurrogate = -1;
+        if(end - position >= 2 && position[0] == '\\' && position[1] == 'u'){
+            lowSurrogate = readHexDigits(position + 2, end);
+        }
+        if(lowSurrogate < 0xDC00 || lowSurrogate > 0xDFFF){
+            fail("expected the second half of a surrogate pair");
+        }
+        position += 6;
+        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+    }else if(codePoint >= 0xDC00 && codePoint <= 0xDFFF){
+        fail("unexpected second half of a surrogate pair");
+    }
+
+    //Encodes the character as UTF-8
+    if(codePoint < 0x80){
+        text += (char)codePoint;
+    }else if(codePoint < 0x800){
+        text += (char)(0xC0 | (codePoint >> 6));
+        text += (char)(0x80 | (codePoint & 0x3F));
+    }else if(codePoint < 0x10000){
+        text += (char)(0xE0 | (codePoint >> 12));
+        text += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+        text += (char)(0x80 | (codePoint & 0x3F));
+    }else{
+        text += (char)(0xF0 | (codePoint >> 18));
+        text += (char)(0x80 | ((codePoint >> 12) & 0x3F));
+        text += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+        text += (char)(0x80 | (codePoint & 0x3F));
+    }
+}
+
+void JsonReader::startElement(const char* separator){
+    if(hasValues.back()){
+        expect(',', separator);
+    }
+    hasValues.back() = true;
+}
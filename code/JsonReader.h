@@ -0,0 +1,92 @@
+#ifndef JSON_READER_H
+#define JSON_READER_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+using namespace std;
+
+//Deepest that objects and arrays can be nested, which stops damaged files from using up the stack
+const int JSON_READER_MAX_DEPTH = 256;
+
+//Thrown when JSON cannot be read, with the line and column where reading stopped
+class JsonReadError : public runtime_error {
+    public:
+        JsonReadError(const string& message, int errorLine, int errorColumn);
+
+        int line;
+        int column;
+};
+
+//Reads JSON in a single pass, one value at a time, so saves are loaded straight into the objects that use them
+//without building the whole document in memory first. The reader is used in the same order as JsonWriter:
+//objects are read as a series of keys, each followed by reading or skipping its value.
+class JsonReader {
+    public:
+        //Reads JSON from memory, which must stay valid while it is being read
+        JsonReader(const char* data, size_t size);
+        //Reads the whole stream into memory first
+        JsonReader(istream& stream);
+
+        void beginObject();
+        //Reads the key of the next value in an object, or returns false at the end of the object
+        bool nextKey(string& name);
+
+        void beginArray();
+        //Moves to the next value in an array, or returns false at the end of the array
+        bool nextElement();
+
+        //Reads a number, or null as NaN
+        float readFloat();
+        int readInt();
+        unsigned int readUnsigned();
+        bool readBool();
+        string readString();
+
+        //Reads past a value of any type, such as the value of a key that is not needed
+        void skipValue();
+
+        //Checks that there is nothing but whitespace after the last value
+        void endDocument();
+
+        //Throws a JsonReadError at the current position, for data that is valid JSON but not a valid save
+        [[noreturn]] void fail(const string& message);
+
+    private:
+        //Skips whitespace and returns the next character, or 0 at the end of the data
+        char peek();
+
+        //Skips whitespace and moves past the given character, failing if it is not next
+        void expect(char character, const char* description);
+
+        //Moves past the given word, such as true or null
+        void expectWord(const char* word);
+
+        //Moves past a number, returning the characters that it is made of
+        void readNumber(const char*& numberStart, const char*& numberEnd);
+
+        void readString(string& text);
+
+        //Adds a character given by a \u escape, along with the second half of a surrogate pair, as UTF-8
+        void readUnicodeEscape(string& text);
+
+        //Moves past the comma before every value in an object or array apart from the first
+        void startElement(const char* separator);
+
+        //Data that was read from a stream, which the reader owns
+        string ownedData;
+
+        const char* start;
+        const char* position;
+        const char* end;
+
+        //Whether each object or array that is open has already had a value
+        vector<bool> hasValues;
+
+        //Used to read keys that are skipped
+        string skippedText;
+};
+
+#endif
@@ -0,0 +1,160 @@
+#include "JsonWriter.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+JsonWriter::JsonWriter(ostream& outputStream) : stream(outputStream), buffer(JSON_WRITER_BUFFER_SIZE), bufferUsed(0), afterKey(false) {};
+
+JsonWriter::~JsonWriter(){
+    flush();
+}
+
+void JsonWriter::beginObject(){
+    startValue();
+    write('{');
+    hasValues.push_back(false);
+}
+
+void JsonWriter::endObject(){
+    if(hasValues.empty()){
+        cout << "Error in JsonWriter.endObject(), there is no object to end" << endl;
+        return;
+    }
+    hasValues.pop_back();
+    write('}');
+}
+
+void JsonWriter::beginArray(){
+    startValue();
+    write('[');
+    hasValues.push_back(false);
+}
+
+void JsonWriter::endArray(){
+    if(hasValues.empty()){
+        cout << "Error in JsonWriter.endArray(), there is no array to end" << endl;
+        return;
+    }
+    hasValues.pop_back();
+    write(']');
+}
+
+void JsonWriter::key(const char* name){
+    startValue();
+    writeString(name, strlen(name));
+    write(':');
+    afterKey = true;
+}
+
+void JsonWriter::value(float number){
+    startValue();
+
+    //JSON has no way to write NaN or infinity, which withered branches can reach, so they are written as null in the
+    //same way as nlohmann::json
+    if(!isfinite(number)){
+        write("null", 4);
+        return;
+    }
+
+    //Writes the shortest text that reads back as exactly the same float
+    char text[32];
+    to_chars_result result = to_chars(text, text + sizeof(text), number);
+    write(text, result.ptr - text);
+}
+
+void JsonWriter::value(int number){
+    startValue();
+    char text[16];
+    to_chars_result result = to_chars(text, text + sizeof(text), number);
+    write(text, result.ptr - text);
+}
+
+void JsonWriter::value(unsigned int number){
+    startValue();
+    char text[16];
+    to_chars_result result = to_chars(text, text + sizeof(text), number);
+    write(text, result.ptr - text);
+}
+
+void JsonWriter::value(bool boolean){
+    startValue();
+    if(boolean){
+        write("true", 4);
+    }else{
+        write("false", 5);
+    }
+}
+
+void JsonWriter::value(const string& text){
+    startValue();
+    writeString(text.data(), text.size());
+}
+
+void JsonWriter::writeString(const char* text, int length){
+    write('"');
+    for(int i = 0; i < length; i++){
+        char character = text[i];
+        //Escapes characters that cannot appear directly in a JSON string
+        if(character == '"' || character == '\\'){
+            write('\\');
+            write(character);
+        }else if((unsigned char)character < 0x20){
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", character);
+            write(escaped, 6);
+        }else{
+            write(character);
+        }
+    }
+    write('"');
+}
+
+void JsonWriter::flush(){
+    if(bufferUsed > 0){
+        stream.write(buffer.data(), bufferUsed);
+        bufferUsed = 0;
+    }
+    stream.flush();
+}
+
+void JsonWriter::startValue(){
+    if(afterKey){
+        afterKey = false;
+        return;
+    }
+
+    if(!hasValues.empty()){
+        if(hasValues.back()){
+            write(',');
+        }
+        hasValues.back() = true;
+    }
+}
+
+void JsonWriter::write(const char* data, int length){
+    //Sends the buffer to the stream when it is full
+    if(bufferUsed + length > buffer.size()){
+        stream.write(buffer.data(), bufferUsed);
+        bufferUsed = 0;
+
+        //Writes very long data directly instead of splitting it across buffers
+        if(length > buffer.size()){
+            stream.write(data, length);
+            return;
+        }
+    }
+
+    copy(data, data + length, buffer.begin() + bufferUsed);
+    bufferUsed += length;
+}
+
+void JsonWriter::write(char character){
+    if(bufferUsed == buffer.size()){
+        stream.write(buffer.data(), bufferUsed);
+        bufferUsed = 0;
+    }
+    buffer[bufferUsed] = character;
+    bufferUsed++;
+}
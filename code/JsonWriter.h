@@ -0,0 +1,69 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+//Size of the buffer that output is collected in before it is written to the stream
+const int JSON_WRITER_BUFFER_SIZE = 1 << 16;
+
+//Writes JSON straight to a stream as it is generated, so large saves do not have to be built in memory first.
+//Commas are added automatically, so objects are written as a series of keys and values.
+class JsonWriter {
+    public:
+        //The stream must stay open until the writer is flushed or destroyed
+        JsonWriter(ostream& outputStream);
+        //Flushes any output that is still in the buffer
+        ~JsonWriter();
+
+        void beginObject();
+        void endObject();
+        void beginArray();
+        void endArray();
+
+        //Writes the key of the next value in an object
+        void key(const char* name);
+
+        //Writes a number, or null if it is NaN or infinite
+        void value(float number);
+        void value(int number);
+        void value(unsigned int number);
+        void value(bool boolean);
+        void value(const string& text);
+
+        //Writes a key and its value
+        template <typename T>
+        void field(const char* name, const T& fieldValue){
+            key(name);
+            value(fieldValue);
+        }
+
+        //Writes the buffered output to the stream
+        void flush();
+
+    private:
+        //Writes a comma if the next value is not the first in its object or array
+        void startValue();
+
+        //Writes text in quotes, escaping any characters that need it
+        void writeString(const char* text, int length);
+
+        void write(const char* data, int length);
+        void write(char character);
+
+        ostream& stream;
+
+        vector<char> buffer;
+        int bufferUsed;
+
+        //Whether each object or array that is open already has a value in it
+        vector<bool> hasValues;
+
+        //Whether a key has just been written, in which case the value does not need a comma
+        bool afterKey;
+};
+
+#endif
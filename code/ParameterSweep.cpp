@@ -0,0 +1,177 @@
+#include "ParameterSweep.h"
+#include "Forest.h"
+#include "WorkStealingPool.h"
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <climits>
+
+//The name of each parameter on the command line and the field it is stored in
+const pair<const char*, float GrowthConfig::*> GROWTH_PARAMETERS[] = {
+    {"new-branch-threshold", &GrowthConfig::newBranchThreshold},
+    {"new-branch-requirement", &GrowthConfig::newBranchRequirement},
+    {"branch-growth-amount", &GrowthConfig::branchGrowthAmount},
+    {"new-branch-probability", &GrowthConfig::newBranchProbability},
+    {"length-growth-ratio", &GrowthConfig::lengthGrowthRatio},
+    {"supply-used-per-growth", &GrowthConfig::supplyUsedPerGrowth},
+    {"area-per-supply", &GrowthConfig::areaPerSupply},
+    {"sprout-attempts", &GrowthConfig::sproutAttempts},
+};
+
+//The growth law and supply model are not numbers, so they are given by their numbers in the GrowthLaw and
+//SupplyModel enums
+const char* GROWTH_LAW_PARAMETER = "growth-law";
+const char* SUPPLY_MODEL_PARAMETER = "supply-model";
+
+//The result of growing a single tree
+struct SweepTreeResult {
+    int numBranches;
+    float totalArea;
+    int depth;
+    bool withered;
+    double growTime;
+};
+
+vector<string> getGrowthParameterNames(){
+    vector<string> names;
+    for(const auto& parameter : GROWTH_PARAMETERS){
+        names.push_back(parameter.first);
+    }
+    names.push_back(GROWTH_LAW_PARAMETER);
+    names.push_back(SUPPLY_MODEL_PARAMETER);
+    return names;
+}
+
+bool setGrowthParameter(GrowthConfig& config, const string& name, float value){
+    for(const auto& parameter : GROWTH_PARAMETERS){
+        if(name == parameter.first){
+            config.*parameter.second = value;
+            return true;
+        }
+    }
+    if(name == GROWTH_LAW_PARAMETER && value >= QUADRATIC_GROWTH && value <= LOGISTIC_GROWTH){
+        config.growthLaw = (GrowthLaw)value;
+        return true;
+    }
+    if(name == SUPPLY_MODEL_PARAMETER && value >= EVEN_SUPPLY && value <= VASCULAR_SUPPLY){
+        config.supplyModel = (SupplyModel)value;
+        return true;
+    }
+    return false;
+}
+
+float getGrowthParameter(const GrowthConfig& config, const string& name){
+    for(const auto& parameter : GROWTH_PARAMETERS){
+        if(name == parameter.first){
+            return config.*parameter.second;
+        }
+    }
+    if(name == GROWTH_LAW_PARAMETER){
+        return config.growthLaw;
+    }
+    if(name == SUPPLY_MODEL_PARAMETER){
+        return config.supplyModel;
+    }
+    return 0;
+}
+
+vector<GrowthConfig> buildConfigGrid(const GrowthConfig& baseConfig, const vector<pair<string, vector<float>>>& parameterValues){
+    vector<GrowthConfig> configs = {baseConfig};
+
+    //Each parameter multiplies the number of configs by its number of values
+    for(int i = 0; i < parameterValues.size(); i++){
+        vector<GrowthConfig> nextConfigs;
+        for(int j = 0; j < configs.size(); j++){
+            for(int k = 0; k < parameterValues[i].second.size(); k++){
+                GrowthConfig config = configs[j];
+                if(!setGrowthParameter(config, parameterValues[i].first, parameterValues[i].second[k])){
+                    cout << "Error in buildConfigGrid(), there is no growth parameter called " << parameterValues[i].first << endl;
+                    return {};
+                }
+                nextConfigs.push_back(config);
+            }
+        }
+        configs = nextConfigs;
+    }
+
+    return configs;
+}
+
+//Grows one tree, which runs on one of the pool's threads
+SweepTreeResult growSweepTree(const GrowthConfig& config, unsigned int seed, const SweepSettings& settings){
+    auto start = chrono::steady_clock::now();
+
+    Tree* tree = buildBinaryTree(settings.numBranches, seed);
+    tree->setGrowthConfig(config);
+
+    float waterConsumed;
+    float nutrientsConsumed;
+    vector<float> widthIncreases;
+    vector<float> lengthIncreases;
+    vector<int> branchesGrown;
+    bool withered = false;
+    for(int step = 0; step < settings.numSteps && !withered; step++){
+        widthIncreases.clear();
+        lengthIncreases.clear();
+        branchesGrown.clear();
+        tree->addWater(settings.waterPerStep);
+        tree->addNutrients(settings.nutrientsPerStep);
+        tree->grow(waterConsumed, nutrientsConsumed, widthIncreases, lengthIncreases, branchesGrown);
+
+        float totalArea = tree->getTotalArea();
+        withered = !isfinite(totalArea) || totalArea <= 0;
+    }
+
+    SweepTreeResult result = {tree->getNumBranches(), tree->getTotalArea(), tree->getDepth(), withered, 0};
+    delete tree;
+
+    result.growTime = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+vector<SweepResult> runSweep(const vector<GrowthConfig>& configs, const SweepSettings& settings){
+    //Every seed of every config is a separate task. The tasks of one config are next to each other, so they start
+    //on the same thread, and configs that grow many branches are shared out by work stealing.
+    vector<SweepTreeResult> treeResults(configs.size()*settings.numSeeds);
+    WorkStealingPool pool(max(settings.numThreads, 1));
+    pool.run(treeResults.size(), [&](int task){
+        int config = task/settings.numSeeds;
+        unsigned int seed = settings.firstSeed + task%settings.numSeeds;
+        treeResults[task] = growSweepTree(configs[config], seed, settings);
+    });
+
+    //The results are added up after every tree has grown, so the threads never share anything but their queues
+    vector<SweepResult> results;
+    for(int i = 0; i < configs.size(); i++){
+        SweepResult result = {configs[i], settings.numSeeds, 0, INT_MAX, 0, 0, 0, 0, 0};
+        int numGrowing = 0;
+        for(int seed = 0; seed < settings.numSeeds; seed++){
+            const SweepTreeResult& treeResult = treeResults[i*settings.numSeeds + seed];
+            result.meanBranches += treeResult.numBranches;
+            result.minBranches = min(result.minBranches, treeResult.numBranches);
+            result.maxBranches = max(result.maxBranches, treeResult.numBranches);
+            result.growTime += treeResult.growTime;
+
+            if(treeResult.withered){
+                result.numWithered++;
+            }else{
+                result.meanArea += treeResult.totalArea;
+                result.meanDepth += treeResult.depth;
+                numGrowing++;
+            }
+        }
+
+        if(settings.numSeeds > 0){
+            result.meanBranches /= settings.numSeeds;
+        }else{
+            result.minBranches = 0;
+        }
+        if(numGrowing > 0){
+            result.meanArea /= numGrowing;
+            result.meanDepth /= numGrowing;
+        }
+        results.push_back(result);
+    }
+
+    return results;
+}
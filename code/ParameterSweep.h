@@ -0,0 +1,57 @@
+#ifndef PARAMETER_SWEEP_H
+#define PARAMETER_SWEEP_H
+
+#include <string>
+#include <vector>
+#include <thread>
+#include "GrowthConfig.h"
+
+using namespace std;
+
+//How the trees in a sweep are grown. Every config is tried with the same seeds, so the results can be compared.
+struct SweepSettings {
+    int numSeeds = 10;
+    unsigned int firstSeed = 1;
+    int numSteps = 50;
+    //Number of branches in each tree at the start
+    int numBranches = 1;
+    //Water and nutrients given to each tree before every step
+    float waterPerStep = 10;
+    float nutrientsPerStep = 10;
+    int numThreads = thread::hardware_concurrency();
+};
+
+//The results of growing a tree from every seed with one config
+struct SweepResult {
+    GrowthConfig config;
+    int numTrees;
+    double meanBranches;
+    int minBranches;
+    int maxBranches;
+    //Mean area and depth of the trees that are still growing
+    double meanArea;
+    double meanDepth;
+    //Trees whose branches shrank away to nothing, which stop growing
+    int numWithered;
+    //Time spent growing the trees, added up across the threads
+    double growTime;
+};
+
+//Returns the names of the parameters in a GrowthConfig, such as "new-branch-probability". The growth law is
+//"growth-law", where 0 is quadratic, 1 is linear and 2 is logistic, and the supply model is "supply-model", where
+//0 is even and 1 is vascular.
+vector<string> getGrowthParameterNames();
+
+//Sets or gets the parameter with the given name. Returns false, or 0 for getGrowthParameter(), if there is no
+//parameter with that name.
+bool setGrowthParameter(GrowthConfig& config, const string& name, float value);
+float getGrowthParameter(const GrowthConfig& config, const string& name);
+
+//Returns every combination of the given values of each parameter, with the other parameters taken from the base
+//config. The last parameter changes fastest.
+vector<GrowthConfig> buildConfigGrid(const GrowthConfig& baseConfig, const vector<pair<string, vector<float>>>& parameterValues);
+
+//Grows a tree from every seed with every config in parallel, returning the results in the same order as the configs
+vector<SweepResult> runSweep(const vector<GrowthConfig>& configs, const SweepSettings& settings);
+
+#endif
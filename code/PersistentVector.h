@@ -0,0 +1,142 @@
+#ifndef PERSISTENT_VECTOR_H
+#define PERSISTENT_VECTOR_H
+
+#include <memory>
+#include <vector>
+#include <iostream>
+
+using namespace std;
+
+//A vector whose copies share memory. Elements are stored in a tree of nodes with up to 32 children each,
+//so copying the vector only copies a pointer to the root node. Changing an element copies the nodes on
+//the path to it that are shared with another copy (O(log n)), and changes the nodes in place otherwise.
+template <typename T>
+class PersistentVector {
+    public:
+        PersistentVector() : numElements(0), rootShift(0) {};
+
+        int size() const {
+            return numElements;
+        }
+
+        //Returns an element for reading
+        const T& operator[](int position) const {
+            const Node* node = root.get();
+            for(int shift = rootShift; shift > 0; shift -= NODE_BITS){
+                node = node->children[(position >> shift) & NODE_MASK].get();
+            }
+            return node->values[position & NODE_MASK];
+        }
+
+        //Returns an element for changing, first copying any nodes that are shared with another copy
+        T& modify(int position){
+            Node* node = makeUnique(root);
+            for(int shift = rootShift; shift > 0; shift -= NODE_BITS){
+                node = makeUnique(node->children[(position >> shift) & NODE_MASK]);
+            }
+            return node->values[position & NODE_MASK];
+        }
+
+        void push_back(const T& value){
+            if(root == nullptr){
+                root = make_shared<Node>();
+            }
+
+            //Adds a level to the top of the tree once every leaf is full
+            if(numElements == (1 << (rootShift+NODE_BITS))){
+                shared_ptr<Node> newRoot = make_shared<Node>();
+                newRoot->children.push_back(root);
+                root = newRoot;
+                rootShift += NODE_BITS;
+            }
+
+            //Creates any missing nodes on the way to the new element's leaf
+            Node* node = makeUnique(root);
+            for(int shift = rootShift; shift > 0; shift -= NODE_BITS){
+                int childPosition = (numElements >> shift) & NODE_MASK;
+                if(childPosition == node->children.size()){
+                    node->children.push_back(make_shared<Node>());
+                }
+                node = makeUnique(node->children[childPosition]);
+            }
+
+            node->values.push_back(value);
+            numElements++;
+        }
+
+        void pop_back(){
+            if(numElements == 0){
+                cout << "Error in PersistentVector.pop_back(), the vector is empty" << endl;
+                return;
+            }
+
+            numElements--;
+            removeLast(root, rootShift);
+
+            //Removes levels from the top of the tree that only have one child
+            while(rootShift > 0 && root->children.size() == 1){
+                root = root->children[0];
+                rootShift -= NODE_BITS;
+            }
+            if(numElements == 0){
+                clear();
+            }
+        }
+
+        //Removes the element at the given position, moving each later element down by one
+        void erase(int position){
+            for(int i = position; i < numElements-1; i++){
+                modify(i) = (*this)[i+1];
+            }
+            pop_back();
+        }
+
+        void clear(){
+            root = nullptr;
+            numElements = 0;
+            rootShift = 0;
+        }
+
+    private:
+        static const int NODE_BITS = 5;
+        static const int NODE_MASK = (1 << NODE_BITS)-1;
+
+        //Internal nodes only use children and leaf nodes only use values
+        struct Node {
+            vector<shared_ptr<Node>> children;
+            vector<T> values;
+        };
+
+        //Makes sure the node is not shared with another copy of the vector, copying it if it is
+        static Node* makeUnique(shared_ptr<Node>& node){
+            if(node.use_count() > 1){
+                node = make_shared<Node>(*node);
+            }
+            return node.get();
+        }
+
+        //Removes the last element below the given node, and any nodes that it leaves empty
+        void removeLast(shared_ptr<Node>& node, int shift){
+            Node* uniqueNode = makeUnique(node);
+
+            if(shift == 0){
+                uniqueNode->values.pop_back();
+                return;
+            }
+
+            removeLast(uniqueNode->children.back(), shift-NODE_BITS);
+
+            Node* lastChild = uniqueNode->children.back().get();
+            if(lastChild->children.size() == 0 && lastChild->values.size() == 0){
+                uniqueNode->children.pop_back();
+            }
+        }
+
+        shared_ptr<Node> root;
+        int numElements;
+
+        //Number of bits of a position that are used below the root node
+        int rootShift;
+};
+
+#endif
@@ -64,6 +64,30 @@ nlohmann::json Player::toJson() const {
     return j;
 }
 
+void Player::writeJson(JsonWriter& writer) const {
+    writer.beginObject();
+    writer.field("waterSupply", waterSupply);
+    writer.field("fertiliserSupply", fertiliserSupply);
+    writer.endObject();
+}
+
+Player Player::readJson(JsonReader& reader) {
+    float water = 0;
+    float fertiliser = 0;
+    string key;
+    reader.beginObject();
+    while (reader.nextKey(key)) {
+        if (key == "waterSupply") {
+            water = reader.readFloat();
+        } else if (key == "fertiliserSupply") {
+            fertiliser = reader.readFloat();
+        } else {
+            reader.skipValue();
+        }
+    }
+    return Player(water, fertiliser);
+}
+
 // Deserialization from JSON
 Player Player::fromJson(const nlohmann::json& j) {
     float water = j.at("waterSupply").get<float>();
@@ -2,6 +2,8 @@
 #define PLAYER_H
 
 #include "Printable.h"
+#include "JsonWriter.h"
+#include "JsonReader.h"
 
 // Forward declaration for nlohmann::json
 namespace nlohmann {
@@ -36,6 +38,10 @@ public:
     // Serialization/Deserialization
     nlohmann::json toJson() const;
     static Player fromJson(const nlohmann::json& j);
+    //Writes the same JSON as toJson() straight to a writer
+    void writeJson(JsonWriter& writer) const;
+    //Reads a player written by writeJson() or toJson() straight from a reader
+    static Player readJson(JsonReader& reader);
 };
 
 #endif
\ No newline at end of file
@@ -3,13 +3,20 @@
 PruningAction::PruningAction(Tree* currentTree, int branchIndex) : index(branchIndex), treeToModify(currentTree) {};
 
 bool PruningAction::performAction(){
+    //Keeps the removed branches so that they can be added back
     treeToModify->pruneBranch(index, branchesRemoved);
 
     return true;
 }
 
 void PruningAction::reverseAction(){
-    treeToModify->addBranches(branchesRemoved);
+    //Gives the tree copies of the removed branches, so the action can be reversed again after a redo
+    treeToModify->restoreBranches(branchesRemoved);
+}
+
+void PruningAction::redoAction(){
+    //Pruning the same branch again always removes the same branches
+    performAction();
 }
 
 void PruningAction::printData(){
@@ -19,8 +26,40 @@ void PruningAction::printData(){
 
     cout << "List of branches removed:" << endl;
 
-    for(int i = 0; i < branchesRemoved.size(); i++){
+    for(int i = 0; i < branchesRemoved.branches.size(); i++){
         //Print out the details of each branch
-        branchesRemoved[i]->printData();
+        branchesRemoved.branches[i].printData();
     }
-}
\ No newline at end of file
+}
+
+ActionType PruningAction::getType(){
+    return PRUNE_ACTION;
+}
+
+float PruningAction::getCommandAmount(){
+    return index;
+}
+
+void PruningAction::writeToJournal(ostream& journal){
+    writeValue(journal, index);
+
+    //Writes every removed branch so they can be added back when the action is reversed
+    writeValue<int>(journal, branchesRemoved.branches.size());
+    for(int i = 0; i < branchesRemoved.branches.size(); i++){
+        branchesRemoved.branches[i].writeBinary(journal);
+    }
+    writeVector(journal, branchesRemoved.listPositions);
+    writeValue(journal, branchesRemoved.positionInParent);
+}
+
+void PruningAction::readFromJournal(istream& journal){
+    index = readValue<int>(journal);
+
+    int numBranches = readValue<int>(journal);
+    branchesRemoved.branches.clear();
+    for(int i = 0; i < numBranches; i++){
+        branchesRemoved.branches.push_back(Branch::readBinary(journal));
+    }
+    branchesRemoved.listPositions = readVector<int>(journal);
+    branchesRemoved.positionInParent = readValue<int>(journal);
+}
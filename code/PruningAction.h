@@ -5,22 +5,30 @@
 #include "Action.h"
 #include "Tree.h"
 
-class PruningAction : public Action{
+class PruningAction{
     public:
         PruningAction(Tree* currentTree, int branchIndex);
 
         bool performAction();
         void reverseAction();
+        void redoAction();
 
         void printData();
 
+        ActionType getType();
+        float getCommandAmount();
+        void writeToJournal(ostream& journal);
+        void readFromJournal(istream& journal);
+
     private:
         int index;
-        vector<Branch*> branchesRemoved;
+
+        //The branches that were removed, which are put back where they were when the action is reversed
+        DetachedBranches branchesRemoved;
 
         Tree* treeToModify;
 
 };
 
 
-#endif
\ No newline at end of file
+#endif
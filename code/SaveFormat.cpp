@@ -0,0 +1,304 @@
+#include "SaveFormat.h"
+#include "Timeline.h"
+#include "JsonWriter.h"
+#include "JsonReader.h"
+#include <fstream>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+bool writeBinarySave(const string& path, Tree* tree, Player* player){
+    ofstream file(path, ios::binary);
+    if(!file.is_open()){
+        cout << "Error in writeBinarySave(), could not open " << path << " for writing" << endl;
+        return false;
+    }
+
+    SaveHeader header;
+    memcpy(header.magic, SAVE_MAGIC, sizeof(header.magic));
+    header.version = SAVE_FORMAT_VERSION;
+    header.waterSupply = player->getWaterSupply();
+    header.fertiliserSupply = player->getFertiliserSupply();
+    writeValue(file, header);
+
+    tree->writeSave(file);
+
+    if(!file){
+        cout << "Error in writeBinarySave(), could not write to " << path << endl;
+        return false;
+    }
+    return true;
+}
+
+bool writePackedSave(const string& path, Tree* tree, Player* player, bool quantizeGeometry){
+    ofstream file(path, ios::binary);
+    if(!file.is_open()){
+        cout << "Error in writePackedSave(), could not open " << path << " for writing" << endl;
+        return false;
+    }
+
+    PackedSaveHeader header;
+    memcpy(header.magic, PACKED_SAVE_MAGIC, sizeof(header.magic));
+    header.version = PACKED_SAVE_FORMAT_VERSION;
+    header.flags = quantizeGeometry ? PACKED_QUANTIZED_GEOMETRY : 0;
+    header.waterSupply = player->getWaterSupply();
+    header.fertiliserSupply = player->getFertiliserSupply();
+    writeValue(file, header);
+
+    tree->writePackedSave(file, quantizeGeometry);
+
+    if(!file){
+        cout << "Error in writePackedSave(), could not write to " << path << endl;
+        return false;
+    }
+    return true;
+}
+
+bool writeJsonSave(const string& path, Tree* tree, Player* player, TimelineSave* timeline){
+    ofstream file(path);
+    if(!file.is_open()){
+        cout << "Error in writeJsonSave(), could not open " << path << " for writing" << endl;
+        return false;
+    }
+
+    {
+        JsonWriter writer(file);
+        writer.beginObject();
+        if(timeline != nullptr){
+            writer.key("timeline");
+            timeline->writeJson(writer);
+            writer.field("checksum", tree->getChecksum());
+        }else{
+            writer.key("tree");
+            tree->writeJson(writer);
+            writer.key("player");
+            player->writeJson(writer);
+        }
+        writer.endObject();
+    }
+
+    if(!file){
+        cout << "Error in writeJsonSave(), could not write to " << path << endl;
+        return false;
+    }
+    return true;
+}
+
+//Returns true if the path ends in the given extension
+static bool hasExtension(const string& path, const string& extension){
+    return path.size() >= extension.size() && path.compare(path.size()-extension.size(), extension.size(), extension) == 0;
+}
+
+bool isJsonSavePath(const string& path){
+    return hasExtension(path, ".json");
+}
+
+bool isPackedSavePath(const string& path){
+    return hasExtension(path, ".pack");
+}
+
+bool writeSave(const string& path, Tree* tree, Player* player, TimelineSave* timeline){
+    if(isJsonSavePath(path)){
+        return writeJsonSave(path, tree, player, timeline);
+    }else if(isPackedSavePath(path)){
+        return writePackedSave(path, tree, player);
+    }
+    return writeBinarySave(path, tree, player);
+}
+
+bool loadSave(const string& path, Tree*& tree, Player*& player){
+    if(isJsonSavePath(path)){
+        return loadJsonSave(path, tree, player);
+    }else if(isPackedSavePath(path)){
+        return loadPackedSave(path, tree, player);
+    }
+    return loadBinarySave(path, tree, player);
+}
+
+bool replaceFile(const string& newFilePath, const string& path){
+    //Makes sure the new file is on disk before it replaces the old one
+    int newFile = open(newFilePath.c_str(), O_RDONLY);
+    if(newFile == -1 || fsync(newFile) != 0){
+        cout << "Error in replaceFile(), could not store " << newFilePath << endl;
+        if(newFile != -1){
+            close(newFile);
+        }
+        return false;
+    }
+    close(newFile);
+
+    if(rename(newFilePath.c_str(), path.c_str()) != 0){
+        cout << "Error in replaceFile(), could not replace " << path << endl;
+        return false;
+    }
+    return true;
+}
+
+bool loadBinarySave(const string& path, Tree*& tree, Player*& player){
+    int fileDescriptor = open(path.c_str(), O_RDONLY);
+    if(fileDescriptor < 0){
+        cout << "Error in loadBinarySave(), could not open " << path << endl;
+        return false;
+    }
+
+    struct stat fileInfo;
+    if(fstat(fileDescriptor, &fileInfo) != 0 || fileInfo.st_size < sizeof(SaveHeader)){
+        cout << "Error in loadBinarySave(), " << path << " is too small to be a save" << endl;
+        close(fileDescriptor);
+        return false;
+    }
+    size_t fileSize = fileInfo.st_size;
+
+    //Maps the file into memory, so the branch arrays are read straight from the page cache without parsing
+    void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    close(fileDescriptor);
+    if(mapping == MAP_FAILED){
+        cout << "Error in loadBinarySave(), could not map " << path << " into memory" << endl;
+        return false;
+    }
+    const char* data = static_cast<const char*>(mapping);
+
+    SaveHeader header;
+    memcpy(&header, data, sizeof(header));
+
+    Tree* loadedTree = nullptr;
+    if(memcmp(header.magic, SAVE_MAGIC, sizeof(header.magic)) != 0){
+        cout << "Error in loadBinarySave(), " << path << " is not a binary save" << endl;
+    }else if(header.version < 1 || header.version > SAVE_FORMAT_VERSION){
+        cout << "Error in loadBinarySave(), " << path << " has version " << header.version
+             << " but only versions up to " << SAVE_FORMAT_VERSION << " can be loaded" << endl;
+    }else{
+        //The growth config was added in version 2
+        loadedTree = Tree::fromSave(data + sizeof(header), fileSize - sizeof(header), header.version >= 2);
+    }
+
+    munmap(mapping, fileSize);
+
+    if(loadedTree == nullptr){
+        return false;
+    }
+
+    tree = loadedTree;
+    player = new Player(header.waterSupply, header.fertiliserSupply);
+    return true;
+}
+
+bool readJsonSave(const string& path, JsonSave& save){
+    ifstream file(path, ios::binary);
+    if(!file.is_open()){
+        cout << "Error in readJsonSave(), could not open " << path << endl;
+        return false;
+    }
+
+    try {
+        JsonReader reader(file);
+        string key;
+        reader.beginObject();
+        while(reader.nextKey(key)){
+            if(key == "tree"){
+                save.tree.reset(Tree::readJson(reader));
+            }else if(key == "player"){
+                save.player.reset(new Player(Player::readJson(reader)));
+            }else if(key == "timeline"){
+                save.timeline.reset(new TimelineSave(TimelineSave::readJson(reader)));
+            }else if(key == "checksum"){
+                save.checksum = reader.readUnsigned();
+                save.hasChecksum = true;
+            }else{
+                reader.skipValue();
+            }
+        }
+        reader.endDocument();
+    } catch (JsonReadError& e) {
+        cout << "Error in readJsonSave(), could not read " << path << ": " << e.what() << endl;
+        return false;
+    }
+
+    if(save.timeline == nullptr && (save.tree == nullptr || save.player == nullptr)){
+        cout << "Error in readJsonSave(), " << path << " does not contain a tree and a player" << endl;
+        return false;
+    }
+    return true;
+}
+
+bool loadJsonSave(const string& path, Tree*& tree, Player*& player){
+    JsonSave save;
+    if(!readJsonSave(path, save)){
+        return false;
+    }
+
+    //Compact saves store the start of the timeline, which is rebuilt by replaying its commands
+    if(save.timeline != nullptr){
+        save.tree.reset(new Tree(save.timeline->startTree));
+        save.player.reset(new Player(save.timeline->startPlayer));
+        Timeline replayTimeline(save.tree.get(), save.player.get());
+        replayTimeline.replayCommands(save.timeline->commands);
+
+        if(save.hasChecksum && save.checksum != save.tree->getChecksum()){
+            cout << "Error in loadJsonSave(), " << path << " replayed to a different tree than the one that was saved" << endl;
+            return false;
+        }
+    }
+
+    tree = save.tree.release();
+    player = save.player.release();
+    return true;
+}
+
+bool loadPackedSave(const string& path, Tree*& tree, Player*& player){
+    ifstream file(path, ios::binary | ios::ate);
+    if(!file.is_open()){
+        cout << "Error in loadPackedSave(), could not open " << path << endl;
+        return false;
+    }
+
+    //Reads the whole file at once, as every value has to be decoded anyway
+    vector<char> data(file.tellg());
+    file.seekg(0);
+    file.read(data.data(), data.size());
+    if(!file || data.size() < sizeof(PackedSaveHeader)){
+        cout << "Error in loadPackedSave(), " << path << " is too small to be a save" << endl;
+        return false;
+    }
+
+    PackedSaveHeader header;
+    memcpy(&header, data.data(), sizeof(header));
+    if(memcmp(header.magic, PACKED_SAVE_MAGIC, sizeof(header.magic)) != 0){
+        cout << "Error in loadPackedSave(), " << path << " is not a packed save" << endl;
+        return false;
+    }
+    if(header.version < 1 || header.version > PACKED_SAVE_FORMAT_VERSION){
+        cout << "Error in loadPackedSave(), " << path << " has version " << header.version
+             << " but only versions up to " << PACKED_SAVE_FORMAT_VERSION << " can be loaded" << endl;
+        return false;
+    }
+
+    //The growth config was added in version 2
+    Tree* loadedTree = Tree::fromPackedSave(data.data() + sizeof(header), data.size() - sizeof(header),
+        header.flags & PACKED_QUANTIZED_GEOMETRY, header.version >= 2);
+    if(loadedTree == nullptr){
+        return false;
+    }
+
+    tree = loadedTree;
+    player = new Player(header.waterSupply, header.fertiliserSupply);
+    return true;
+}
+
+bool convertSave(const string& inputPath, const string& outputPath){
+    Tree* tree = nullptr;
+    Player* player = nullptr;
+
+    if(!loadSave(inputPath, tree, player)){
+        return false;
+    }
+
+    //Binary and packed saves have no timeline, so JSON saves are written as full saves
+    bool written = writeSave(outputPath, tree, player);
+
+    delete tree;
+    delete player;
+    return written;
+}
@@ -0,0 +1,138 @@
+#ifndef SAVE_FORMAT_H
+#define SAVE_FORMAT_H
+
+#include <string>
+#include <memory>
+#include "Tree.h"
+#include "Player.h"
+#include "Timeline.h"
+
+using namespace std;
+
+//Binary saves start with these characters, followed by the version of the format
+const char SAVE_MAGIC[4] = {'T', 'T', 'T', 'S'};
+const unsigned int SAVE_FORMAT_VERSION = 2;
+
+//Every value in a binary save is 4 bytes, stored in the byte order of the computer that wrote it,
+//so the arrays can be used directly from a memory mapped file.
+//
+//A save is a SaveHeader followed by the tree, which is a TreeSaveHeader followed by these arrays:
+//    int indices[numBranches]
+//    int parentIndices[numBranches]
+//    float centreXs[numBranches]
+//    float centreYs[numBranches]
+//    float widths[numBranches]
+//    float lengths[numBranches]
+//    float angles[numBranches]
+//    int ages[numBranches]
+//    int childOffsets[numBranches+1]    The children of branch i are children[childOffsets[i]] up to children[childOffsets[i+1]]
+//    int children[numChildLinks]
+//followed by the growth config of the tree, which is every float parameter of the GrowthConfig in the order
+//SAVED_GROWTH_PARAMETERS in Tree.cpp lists them, then int growthLaw and int supplyModel.
+//Version 1 saves have no growth config, and are loaded with the default config.
+
+//Packed saves are much smaller than the other formats, at the cost of decoding every value when loading.
+//They start with a PackedSaveHeader, followed by these values for the tree, where varints store 7 bits in
+//each byte and signed varints store small negative numbers in few bytes:
+//    varint numBranches
+//    float waterLevel, maxWater, nutrientLevel, maxNutrients
+//    varint maxIndex
+//    unsigned int randomState
+//    the growth config, stored in the same way as in binary saves, except in version 1 saves
+//and then for each branch:
+//    signed varint index - the index of the branch before it
+//    signed varint index - parentIndex
+//    varint age*2 + 1 if the position of the branch is stored
+//    varint numChildren, then a signed varint for each child of childIndex - the index before it
+//    float width, length, angle, or with PACKED_QUANTIZED_GEOMETRY, signed varints of them multiplied by
+//    PACKED_SIZE_SCALE and PACKED_ANGLE_SCALE
+//    float centreX, centreY if the position is stored, which it always is unless the geometry is quantized,
+//    where only branches without a parent store it and the rest are moved to the tips of their parents
+const char PACKED_SAVE_MAGIC[4] = {'T', 'T', 'T', 'P'};
+const unsigned int PACKED_SAVE_FORMAT_VERSION = 2;
+const unsigned int PACKED_QUANTIZED_GEOMETRY = 1;
+const float PACKED_SIZE_SCALE = 64;
+const float PACKED_ANGLE_SCALE = 1000;
+
+struct SaveHeader {
+    char magic[4];
+    unsigned int version;
+    float waterSupply;
+    float fertiliserSupply;
+};
+
+struct PackedSaveHeader {
+    char magic[4];
+    unsigned int version;
+    unsigned int flags;
+    float waterSupply;
+    float fertiliserSupply;
+};
+
+struct TreeSaveHeader {
+    unsigned int numBranches;
+    unsigned int numChildLinks;
+    float waterLevel;
+    float maxWater;
+    float nutrientLevel;
+    float maxNutrients;
+    int maxIndex;
+    unsigned int randomState;
+};
+
+//The contents of a JSON save. Full saves have a tree and a player, and compact saves have a timeline and a checksum.
+struct JsonSave {
+    unique_ptr<Tree> tree;
+    unique_ptr<Player> player;
+    unique_ptr<TimelineSave> timeline;
+    bool hasChecksum = false;
+    unsigned int checksum = 0;
+};
+
+//Writes the tree and player to a binary save, returning false if the file could not be written
+bool writeBinarySave(const string& path, Tree* tree, Player* player);
+
+//Writes the tree and player to a packed save, returning false if the file could not be written
+bool writePackedSave(const string& path, Tree* tree, Player* player, bool quantizeGeometry = false);
+
+//Writes a JSON save. Compact saves store the given timeline and a checksum of the tree, and full saves,
+//where the timeline is nullptr, store the tree and player.
+bool writeJsonSave(const string& path, Tree* tree, Player* player, TimelineSave* timeline = nullptr);
+
+//Returns true if the path is for a JSON save, which is any path ending in ".json"
+bool isJsonSavePath(const string& path);
+//Returns true if the path is for a packed save, which is any path ending in ".pack"
+bool isPackedSavePath(const string& path);
+
+//Writes a save in the format chosen by the end of the path, which is JSON, packed or otherwise binary.
+//The timeline is only written to JSON saves.
+bool writeSave(const string& path, Tree* tree, Player* player, TimelineSave* timeline = nullptr);
+
+//Loads a save in the format chosen by the end of the path
+bool loadSave(const string& path, Tree*& tree, Player*& player);
+
+//Makes sure a newly written file is stored on disk and then renames it over the given path. Renaming is atomic,
+//so the file at the path is always either the old file or the complete new file.
+bool replaceFile(const string& newFilePath, const string& path);
+
+//Loads a binary save by memory mapping the file. On success the tree and player are set to new objects,
+//otherwise they are left unchanged and false is returned.
+bool loadBinarySave(const string& path, Tree*& tree, Player*& player);
+
+//Reads a JSON save in a single pass, without replaying the commands of compact saves.
+//Returns false if the file cannot be read or does not hold a full or compact save.
+bool readJsonSave(const string& path, JsonSave& save);
+
+//Loads a JSON save, replaying its commands if it only stores the start of the timeline. Compact saves whose
+//replayed tree does not match the saved checksum are refused.
+//On success the tree and player are set to new objects, otherwise they are left unchanged and false is returned.
+bool loadJsonSave(const string& path, Tree*& tree, Player*& player);
+
+//Loads a packed save. On success the tree and player are set to new objects, otherwise they are left unchanged
+//and false is returned.
+bool loadPackedSave(const string& path, Tree*& tree, Player*& player);
+
+//Converts a save between formats, choosing the format of each file by the end of its path
+bool convertSave(const string& inputPath, const string& outputPath);
+
+#endif
@@ -0,0 +1,86 @@
+#include "SaveSlots.h"
+#include "SaveFormat.h"
+#include "BinaryIO.h"
+#include <fstream>
+#include <cstring>
+#include <ctime>
+#include <algorithm>
+
+string getSaveSlotPath(int slot, const string& extension){
+    return "savegame_" + to_string(slot) + extension;
+}
+
+SaveSlotInfo createSaveSlotInfo(int slot, const string& name, Tree* tree){
+    SaveSlotInfo info;
+    memset(&info, 0, sizeof(info));
+    info.slot = slot;
+    //Leaves space for the terminating zero, cutting off long names
+    strncpy(info.name, name.c_str(), SAVE_SLOT_NAME_LENGTH-1);
+    info.numBranches = tree->getNumBranches();
+    info.totalArea = tree->getTotalArea();
+    info.timestamp = time(NULL);
+    return info;
+}
+
+vector<SaveSlotInfo> readSaveSlotIndex(const string& indexPath){
+    vector<SaveSlotInfo> slots;
+
+    ifstream file(indexPath, ios::binary);
+    if(!file.is_open()){
+        return slots;
+    }
+
+    SaveSlotIndexHeader header = readValue<SaveSlotIndexHeader>(file);
+    if(!file || memcmp(header.magic, SAVE_SLOT_INDEX_MAGIC, sizeof(header.magic)) != 0 || header.version != SAVE_SLOT_INDEX_VERSION){
+        cout << "Error in readSaveSlotIndex(), " << indexPath << " is not a save slot index" << endl;
+        return slots;
+    }
+
+    //Checks the size of the file before reading, so a damaged count cannot allocate too much memory
+    streampos slotsStart = file.tellg();
+    file.seekg(0, ios::end);
+    if(file.tellg() - slotsStart < (streamoff)header.numSlots*sizeof(SaveSlotInfo)){
+        cout << "Error in readSaveSlotIndex(), " << indexPath << " does not hold " << header.numSlots << " slots" << endl;
+        return slots;
+    }
+    file.seekg(slotsStart);
+
+    slots.resize(header.numSlots);
+    file.read(reinterpret_cast<char*>(slots.data()), slots.size()*sizeof(SaveSlotInfo));
+    for(int i = 0; i < slots.size(); i++){
+        slots[i].name[SAVE_SLOT_NAME_LENGTH-1] = '\0';
+    }
+    return slots;
+}
+
+bool updateSaveSlotIndex(const string& indexPath, const SaveSlotInfo& info){
+    vector<SaveSlotInfo> slots = readSaveSlotIndex(indexPath);
+
+    //Replaces the slot if it is already in the index, otherwise adds it in order of slot number
+    vector<SaveSlotInfo>::iterator position = lower_bound(slots.begin(), slots.end(), info.slot,
+        [](const SaveSlotInfo& slotInfo, int slot){ return slotInfo.slot < slot; });
+    if(position != slots.end() && position->slot == info.slot){
+        *position = info;
+    }else{
+        slots.insert(position, info);
+    }
+
+    string newIndexPath = indexPath + ".new";
+    {
+        ofstream file(newIndexPath, ios::binary);
+        SaveSlotIndexHeader header;
+        memcpy(header.magic, SAVE_SLOT_INDEX_MAGIC, sizeof(header.magic));
+        header.version = SAVE_SLOT_INDEX_VERSION;
+        header.numSlots = slots.size();
+        writeValue(file, header);
+        writeArray(file, slots);
+        file.close();
+
+        if(!file){
+            cout << "Error in updateSaveSlotIndex(), could not write to " << newIndexPath << endl;
+            return false;
+        }
+    }
+
+    return replaceFile(newIndexPath, indexPath);
+}
@@ -0,0 +1,53 @@
+#ifndef SAVE_SLOTS_H
+#define SAVE_SLOTS_H
+
+#include <string>
+#include <vector>
+#include "Tree.h"
+
+using namespace std;
+
+//Saves are kept in numbered slots, and the details of every slot are kept in a small index file,
+//so the slots can be listed without opening any of their saves
+const string SAVE_SLOT_INDEX_PATH = "saveslots.index";
+
+//Save slot indexes start with these characters, followed by the version of the format and the number of slots
+const char SAVE_SLOT_INDEX_MAGIC[4] = {'T', 'T', 'T', 'I'};
+const unsigned int SAVE_SLOT_INDEX_VERSION = 1;
+
+const int SAVE_SLOT_NAME_LENGTH = 32;
+const int SAVE_THUMBNAIL_WIDTH = 32;
+const int SAVE_THUMBNAIL_HEIGHT = 20;
+
+//The details of a save slot. Every slot takes the same number of bytes, so the whole index is read at once.
+struct SaveSlotInfo {
+    int slot;
+    char name[SAVE_SLOT_NAME_LENGTH];
+    int numBranches;
+    float totalArea;
+    //Seconds since 1970 when the slot was saved
+    long long timestamp;
+    //A small picture of the screen when the slot was saved, with 3 bytes per pixel in blue, green, red order
+    unsigned char thumbnail[SAVE_THUMBNAIL_HEIGHT*SAVE_THUMBNAIL_WIDTH*3];
+};
+
+struct SaveSlotIndexHeader {
+    char magic[4];
+    unsigned int version;
+    unsigned int numSlots;
+};
+
+//Returns the path of the save in a slot, which ends in the given extension such as ".json"
+string getSaveSlotPath(int slot, const string& extension);
+
+//Fills in the details of a tree that is being saved to a slot now, with a blank thumbnail
+SaveSlotInfo createSaveSlotInfo(int slot, const string& name, Tree* tree);
+
+//Reads the details of every slot, in order of slot number. Returns no slots if there is no valid index.
+vector<SaveSlotInfo> readSaveSlotIndex(const string& indexPath);
+
+//Adds the details of a slot to the index, replacing any details already stored for the slot.
+//The new index is written next to the old one and then replaces it, so the index is never left half written.
+bool updateSaveSlotIndex(const string& indexPath, const SaveSlotInfo& info);
+
+#endif
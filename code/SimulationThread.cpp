@@ -0,0 +1,105 @@
+#include "SimulationThread.h"
+#include <chrono>
+
+SnapshotBuffer::SnapshotBuffer(const RenderSnapshot& firstSnapshot) : middle(2), back(0), front(1){
+    for(int i = 0; i < 3; i++){
+        snapshots[i] = new RenderSnapshot(firstSnapshot);
+    }
+}
+
+SnapshotBuffer::~SnapshotBuffer(){
+    for(int i = 0; i < 3; i++){
+        delete snapshots[i];
+    }
+}
+
+void SnapshotBuffer::publish(const RenderSnapshot& snapshot){
+    *snapshots[back] = snapshot;
+
+    //Swaps the finished snapshot into the middle, taking whichever one was there to write next time
+    back = middle.exchange(back | FRESH_SNAPSHOT, memory_order_acq_rel) & ~FRESH_SNAPSHOT;
+}
+
+const RenderSnapshot* SnapshotBuffer::getLatest(){
+    //Only swaps when there is a newer snapshot, otherwise the reader would get an older one back
+    if(middle.load(memory_order_acquire) & FRESH_SNAPSHOT){
+        front = middle.exchange(front, memory_order_acq_rel) & ~FRESH_SNAPSHOT;
+    }
+    return snapshots[front];
+}
+
+SimulationThread::SimulationThread(function<RenderSnapshot()> takeSnapshot, int ticksPerSecond) :
+    takeSnapshot(takeSnapshot), tickLength(1000000/ticksPerSecond), snapshots(takeSnapshot()), numUnfinished(0), running(true){
+    simulationThread = thread(&SimulationThread::simulationLoop, this);
+}
+
+SimulationThread::~SimulationThread(){
+    running = false;
+    simulationThread.join();
+}
+
+void SimulationThread::submit(function<void()> command){
+    numUnfinished++;
+    lock_guard<mutex> lock(commandMutex);
+    commands.push_back({command, nullptr});
+}
+
+void SimulationThread::runAndWait(function<void()> command){
+    promise<void> finished;
+    numUnfinished++;
+    {
+        lock_guard<mutex> lock(commandMutex);
+        commands.push_back({command, &finished});
+    }
+    finished.get_future().wait();
+}
+
+const RenderSnapshot* SimulationThread::getSnapshot(){
+    return snapshots.getLatest();
+}
+
+bool SimulationThread::isBusy(){
+    return numUnfinished > 0;
+}
+
+void SimulationThread::simulationLoop(){
+    auto nextTick = chrono::steady_clock::now();
+    while(true){
+        //Checked before the commands are taken, so commands given before stopping still run
+        bool stopping = !running;
+
+        deque<Command> tickCommands;
+        {
+            lock_guard<mutex> lock(commandMutex);
+            tickCommands.swap(commands);
+        }
+
+        for(int i = 0; i < tickCommands.size(); i++){
+            tickCommands[i].run();
+        }
+
+        if(!tickCommands.empty()){
+            snapshots.publish(takeSnapshot());
+            numUnfinished -= tickCommands.size();
+        }
+
+        //Waiting commands are only told that they have finished once the snapshot that includes them is published
+        for(int i = 0; i < tickCommands.size(); i++){
+            if(tickCommands[i].finished){
+                tickCommands[i].finished->set_value();
+            }
+        }
+
+        if(stopping){
+            return;
+        }
+
+        //Waits for the next tick. A tick that took too long is not made up for, so slow growth does not cause a burst of ticks.
+        nextTick += chrono::microseconds(tickLength);
+        auto now = chrono::steady_clock::now();
+        if(nextTick < now){
+            nextTick = now;
+        }
+        this_thread::sleep_until(nextTick);
+    }
+}
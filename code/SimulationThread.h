@@ -0,0 +1,103 @@
+#ifndef SIMULATION_THREAD_H
+#define SIMULATION_THREAD_H
+
+#include <string>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <future>
+#include "Tree.h"
+
+using namespace std;
+
+//Number of times a second that the simulation thread runs the commands it has been given
+const int SIMULATION_TICKS_PER_SECOND = 30;
+
+//The state of the game that is drawn. It is copied from the game after every tick that changes it, and never
+//changes afterwards. The tree shares its branches with the game's tree, so taking a snapshot is cheap.
+struct RenderSnapshot {
+    Tree tree;
+    float waterSupply;
+    float fertiliserSupply;
+    int currentStep;
+    int numTimelines;
+};
+
+//Passes snapshots from one writer thread to one reader thread without locks. There are three snapshots: one being
+//written, one being read, and the newest finished one between them, which the writer and reader swap theirs with.
+class SnapshotBuffer {
+    public:
+        //Starts with the same snapshot in every position, so there is always one to read
+        SnapshotBuffer(const RenderSnapshot& firstSnapshot);
+        ~SnapshotBuffer();
+
+        //Replaces the newest snapshot. Only called by the writer.
+        void publish(const RenderSnapshot& snapshot);
+
+        //Returns the newest snapshot, which stays valid until the reader calls this again. Only called by the reader.
+        const RenderSnapshot* getLatest();
+
+    private:
+        //Marks the snapshot in the middle as newer than the one the reader has
+        static const int FRESH_SNAPSHOT = 4;
+
+        RenderSnapshot* snapshots[3];
+
+        //Position of the snapshot in the middle, along with FRESH_SNAPSHOT if the reader has not taken it yet
+        atomic<int> middle;
+        //Positions that only the writer or only the reader use
+        int back;
+        int front;
+};
+
+//Runs the simulation on its own thread at a fixed rate, so slow growth of a large tree never holds up drawing.
+//The game gives it commands, which change the game state on the simulation thread at the next tick. After a tick
+//that ran commands, a new snapshot is published for drawing.
+class SimulationThread {
+    public:
+        //Takes the first snapshot and starts the thread. The function is called on the simulation thread after
+        //every tick that runs commands, and must return a copy of everything that is drawn.
+        SimulationThread(function<RenderSnapshot()> takeSnapshot, int ticksPerSecond = SIMULATION_TICKS_PER_SECOND);
+        //Runs the commands that are waiting and stops the thread
+        ~SimulationThread();
+
+        //Runs the command on the simulation thread at the next tick
+        void submit(function<void()> command);
+
+        //Runs the command on the simulation thread at the next tick and waits for the tick to finish, including its
+        //snapshot, for commands whose results are needed straight away, such as loading a game
+        void runAndWait(function<void()> command);
+
+        //Returns the newest snapshot without waiting for the simulation, which stays valid until this is called again.
+        //Only called by the thread that draws the game.
+        const RenderSnapshot* getSnapshot();
+
+        //Returns true while commands are waiting or running
+        bool isBusy();
+
+    private:
+        //A command, along with the promise that is kept once its tick has finished if something is waiting for it
+        struct Command {
+            function<void()> run;
+            promise<void>* finished;
+        };
+
+        void simulationLoop();
+
+        function<RenderSnapshot()> takeSnapshot;
+        int tickLength;
+
+        SnapshotBuffer snapshots;
+
+        //Commands are given by the game and taken by the simulation thread, so they are protected by a mutex
+        mutex commandMutex;
+        deque<Command> commands;
+        atomic<int> numUnfinished;
+
+        atomic<bool> running;
+        thread simulationThread;
+};
+
+#endif
@@ -0,0 +1,34 @@
+#include "SpatialHash.h"
+#include <cmath>
+
+SpatialHash::SpatialHash(float cellSize) : cellSize(cellSize) {};
+
+void SpatialHash::insert(int item, float minX, float minY, float maxX, float maxY){
+    if(!isValidBox(minX, minY, maxX, maxY)){
+        return;
+    }
+
+    int lastColumn = getCell(maxX);
+    int lastRow = getCell(maxY);
+    for(int column = getCell(minX); column <= lastColumn; column++){
+        for(int row = getCell(minY); row <= lastRow; row++){
+            cells[getCellKey(column, row)].push_back(item);
+        }
+    }
+}
+
+void SpatialHash::clear(){
+    cells.clear();
+}
+
+bool SpatialHash::isValidBox(float minX, float minY, float maxX, float maxY) const {
+    return isfinite(minX) && isfinite(minY) && isfinite(maxX) && isfinite(maxY) && minX <= maxX && minY <= maxY;
+}
+
+int SpatialHash::getCell(float coordinate) const {
+    return (int)floor(coordinate/cellSize);
+}
+
+long long SpatialHash::getCellKey(int column, int row) const {
+    return ((long long)column << 32) | (unsigned int)row;
+}
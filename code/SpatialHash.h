@@ -0,0 +1,67 @@
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include <vector>
+#include <unordered_map>
+
+using namespace std;
+
+//Finds the items near an area without checking every item, by sorting them into a grid of square cells.
+//Only the cells that contain items are stored, so the grid can cover any area.
+class SpatialHash {
+    public:
+        //Creates an empty grid. Items should be around the size of a cell or smaller, as larger items are stored
+        //in every cell that they cover.
+        SpatialHash(float cellSize);
+
+        //Adds an item that covers the box between the given corners, which is the smallest corner and then the largest
+        void insert(int item, float minX, float minY, float maxX, float maxY);
+
+        //Calls found() on the items in the cells that the box covers until it returns true, and returns true if it
+        //did. The items are near the box, but they may not actually overlap it, and items that cover several of the
+        //cells can be passed more than once.
+        template <typename Found>
+        bool findAny(float minX, float minY, float maxX, float maxY, Found found) const {
+            if(!isValidBox(minX, minY, maxX, maxY)){
+                return false;
+            }
+
+            int lastColumn = getCell(maxX);
+            int lastRow = getCell(maxY);
+            for(int column = getCell(minX); column <= lastColumn; column++){
+                for(int row = getCell(minY); row <= lastRow; row++){
+                    auto cell = cells.find(getCellKey(column, row));
+                    if(cell == cells.end()){
+                        continue;
+                    }
+                    for(int i = 0; i < cell->second.size(); i++){
+                        if(found(cell->second[i])){
+                            return true;
+                        }
+                    }
+                }
+            }
+            return false;
+        }
+
+        //Removes every item
+        void clear();
+
+    private:
+        //Returns false for boxes with corners that are not numbers, such as those of withered branches, which are
+        //never stored or found
+        bool isValidBox(float minX, float minY, float maxX, float maxY) const;
+
+        //Returns the cell that a coordinate is in along one axis
+        int getCell(float coordinate) const;
+
+        //Combines the column and row of a cell into a single key
+        long long getCellKey(int column, int row) const;
+
+        float cellSize;
+
+        //The items in each cell that has any, by cell key
+        unordered_map<long long, vector<int>> cells;
+};
+
+#endif
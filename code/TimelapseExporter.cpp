@@ -0,0 +1,137 @@
+#include "TimelapseExporter.h"
+#include <iostream>
+#include <cstdio>
+#include <thread>
+#include <atomic>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/videoio.hpp>
+#include "ActionRecord.h"
+
+FrameQueue::FrameQueue(int maxFrames, int frameWidth, int frameHeight) :
+    numFrames(0), maxFrames(maxFrames), width(frameWidth), height(frameHeight), closed(false) {};
+
+Mat FrameQueue::getFreeFrame(){
+    unique_lock<mutex> lock(queueMutex);
+    if(freeFrames.empty() && numFrames < maxFrames){
+        numFrames++;
+        return Mat(height, width, CV_8UC3);
+    }
+
+    frameFree.wait(lock, [this]{ return !freeFrames.empty(); });
+    Mat frame = freeFrames.back();
+    freeFrames.pop_back();
+    return frame;
+}
+
+void FrameQueue::push(Mat frame){
+    {
+        lock_guard<mutex> lock(queueMutex);
+        readyFrames.push_back(frame);
+    }
+    frameReady.notify_one();
+}
+
+bool FrameQueue::pop(Mat& frame){
+    unique_lock<mutex> lock(queueMutex);
+    frameReady.wait(lock, [this]{ return !readyFrames.empty() || closed; });
+    if(readyFrames.empty()){
+        return false;
+    }
+
+    frame = readyFrames.front();
+    readyFrames.pop_front();
+    return true;
+}
+
+void FrameQueue::recycle(Mat frame){
+    {
+        lock_guard<mutex> lock(queueMutex);
+        freeFrames.push_back(frame);
+    }
+    frameFree.notify_one();
+}
+
+void FrameQueue::close(){
+    {
+        lock_guard<mutex> lock(queueMutex);
+        closed = true;
+    }
+    frameReady.notify_one();
+}
+
+void renderTimelapseFrame(Tree& tree, int step, Mat& frame){
+    frame.setTo(Scalar(255, 255, 255));
+    tree.draw(&frame);
+    putText(frame, "Step " + to_string(step), Point(10, frame.rows-20), FONT_HERSHEY_SIMPLEX, 0.7, Scalar(0, 0, 0), 2);
+}
+
+//Returns true if the path ends in the given extension
+static bool hasExtension(const string& path, const string& extension){
+    return path.size() >= extension.size() && path.compare(path.size()-extension.size(), extension.size(), extension) == 0;
+}
+
+static bool isImagePath(const string& path){
+    return hasExtension(path, ".png") || hasExtension(path, ".jpg") || hasExtension(path, ".bmp");
+}
+
+string getTimelapseImagePath(const string& path, int frameNumber){
+    size_t extensionStart = path.rfind('.');
+    char number[16];
+    snprintf(number, sizeof(number), "_%05d", frameNumber);
+    return path.substr(0, extensionStart) + number + path.substr(extensionStart);
+}
+
+bool exportTimelapse(const TimelineSave& save, const string& path, int width, int height, double framesPerSecond){
+    //The video is opened before anything is drawn, so an unsupported path fails straight away
+    VideoWriter video;
+    bool exportingImages = isImagePath(path);
+    if(!exportingImages){
+        int codec = hasExtension(path, ".mp4") ? VideoWriter::fourcc('m', 'p', '4', 'v') : VideoWriter::fourcc('M', 'J', 'P', 'G');
+        if(!video.open(path, codec, framesPerSecond, Size(width, height))){
+            cout << "Error in exportTimelapse(), could not open " << path << " for writing" << endl;
+            return false;
+        }
+    }
+
+    FrameQueue frames(TIMELAPSE_MAX_QUEUED_FRAMES, width, height);
+    atomic<bool> failed(false);
+
+    //Encodes frames in the order they were drawn. After a failure frames are still taken, so the renderer never waits forever.
+    thread encoder([&]{
+        Mat frame;
+        int frameNumber = 0;
+        while(frames.pop(frame)){
+            if(!failed){
+                if(!exportingImages){
+                    video.write(frame);
+                }else if(!imwrite(getTimelapseImagePath(path, frameNumber), frame)){
+                    cout << "Error in exportTimelapse(), could not write " << getTimelapseImagePath(path, frameNumber) << endl;
+                    failed = true;
+                }
+            }
+            frameNumber++;
+            frames.recycle(frame);
+        }
+    });
+
+    //Replays the commands on copies of the start state, which share their branches with the save
+    Tree tree(save.startTree);
+    Player player(save.startPlayer);
+    for(int step = 0; step <= save.commands.size() && !failed; step++){
+        if(step > 0){
+            ActionRecord action = createAction(save.commands[step-1].first, save.commands[step-1].second, &tree, &player);
+            visitAction(action, [](auto& action){ action.performAction(); });
+        }
+
+        Mat frame = frames.getFreeFrame();
+        renderTimelapseFrame(tree, step, frame);
+        frames.push(frame);
+    }
+
+    frames.close();
+    encoder.join();
+    video.release();
+
+    return !failed;
+}
@@ -0,0 +1,74 @@
+#ifndef TIMELAPSE_EXPORTER_H
+#define TIMELAPSE_EXPORTER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <opencv2/core.hpp>
+#include "Tree.h"
+#include "Timeline.h"
+
+using namespace std;
+using namespace cv;
+
+//Size and speed of exported time-lapses when they are not given, which match the game window
+const int TIMELAPSE_WIDTH = 800;
+const int TIMELAPSE_HEIGHT = 500;
+const double TIMELAPSE_FRAMES_PER_SECOND = 10;
+
+//Most frames that are drawn but not yet encoded. This is all the frame memory an export uses, however long it is.
+const int TIMELAPSE_MAX_QUEUED_FRAMES = 8;
+
+//Passes frames from the renderer to the encoder. There is a fixed number of frames, which are drawn into, queued,
+//encoded and then given back to be drawn into again, so the renderer waits whenever it gets too far ahead.
+class FrameQueue {
+    public:
+        FrameQueue(int maxFrames, int frameWidth, int frameHeight);
+
+        //Returns a frame to draw into, waiting until the encoder has finished with one if every frame is in use
+        Mat getFreeFrame();
+
+        //Queues a frame that has been drawn
+        void push(Mat frame);
+
+        //Waits for the next frame that has been drawn. Returns false once the queue is closed and empty.
+        bool pop(Mat& frame);
+
+        //Gives back a frame that has been encoded
+        void recycle(Mat frame);
+
+        //Tells the encoder that no more frames will be pushed
+        void close();
+
+    private:
+        mutex queueMutex;
+        condition_variable frameReady;
+        condition_variable frameFree;
+
+        deque<Mat> readyFrames;
+        vector<Mat> freeFrames;
+
+        //Frames are only created when all of the existing ones are in use, up to the maximum
+        int numFrames;
+        int maxFrames;
+        int width;
+        int height;
+
+        bool closed;
+};
+
+//Draws the tree after the given step of a time-lapse
+void renderTimelapseFrame(Tree& tree, int step, Mat& frame);
+
+//Returns the path of a frame when a time-lapse is exported as images, for example timelapse_00042.png
+string getTimelapseImagePath(const string& path, int frameNumber);
+
+//Replays a saved timeline and exports the tree after every step, from the start of the timeline, as a video.
+//Paths ending in .png, .jpg or .bmp export numbered images instead. Each frame is drawn while the frames before it
+//are encoded on another thread. Returns false if the video or an image could not be written.
+bool exportTimelapse(const TimelineSave& save, const string& path, int width = TIMELAPSE_WIDTH, int height = TIMELAPSE_HEIGHT,
+    double framesPerSecond = TIMELAPSE_FRAMES_PER_SECOND);
+
+#endif
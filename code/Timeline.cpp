@@ -1,39 +1,664 @@
 #include "Timeline.h"
+#include <memory>
 
-Timeline::Timeline(){};
+Timeline::Timeline() : Timeline(nullptr, nullptr) {};
+
+Timeline::Timeline(Tree* currentTree, Player* currentPlayer, int stepsBetweenCheckpoints) :
+    currentNode(0), numActionsInMemory(0), journal(nullptr), memoryBudget(0),
+    treeToTrack(currentTree), playerToTrack(currentPlayer), checkpointInterval(stepsBetweenCheckpoints),
+    autosave(nullptr), autosaveSnapshotInterval(DEFAULT_AUTOSAVE_SNAPSHOT_INTERVAL), autosaveGeneration(0) {
+    //Creates the node for the start of time
+    TimelineNode startOfTime;
+    startOfTime.journalPosition = -1;
+    startOfTime.parent = -1;
+    startOfTime.redoChild = -1;
+    startOfTime.depth = 0;
+    startOfTime.stateHash = currentTree ? currentTree->getStateHash() : 0;
+    startOfTime.checkpoint = nullptr;
+    nodes.push_back(startOfTime);
+
+    //Stores the starting state so that travelling back to the beginning is instant
+    takeCheckpoint();
+};
 
 Timeline::~Timeline(){
-    for (int i = 0; i < listOfActions.size(); i++){
-        //Deallocates the memory storing each action in he timeline
-        delete listOfActions[i];
+    for (int i = 0; i < nodes.size(); i++){
+        //Deallocates the memory storing each checkpoint
+        if(nodes[i].checkpoint != nullptr){
+            delete nodes[i].checkpoint->treeState;
+            delete nodes[i].checkpoint->playerState;
+            delete nodes[i].checkpoint;
+        }
     }
+
+    //Deletes the journal file
+    delete journal;
+
+    //Writes any autosave records that are still waiting
+    delete autosave;
 }
 
-void Timeline::performAction(Action* actionToPerform){
-    //Adds the action to the list
-    listOfActions.push_back(actionToPerform);
+void Timeline::performAction(ActionRecord actionToPerform){
+    //Adds the action after the current node, which starts a new timeline if the current node already has actions after it
+    TimelineNode newNode;
+    newNode.action = move(actionToPerform);
+    newNode.journalPosition = -1;
+    newNode.parent = currentNode;
+    newNode.redoChild = -1;
+    newNode.depth = nodes[currentNode].depth+1;
+    newNode.stateHash = 0;
+    newNode.checkpoint = nullptr;
+
+    nodes.push_back(newNode);
+    int newNodeIndex = nodes.size()-1;
+
+    nodes[currentNode].children.push_back(newNodeIndex);
+    nodes[currentNode].redoChild = newNodeIndex;
+    currentNode = newNodeIndex;
+
+    nodesInMemory.push_back(newNodeIndex);
+    numActionsInMemory++;
+
     //Performs the action immediately
-    actionToPerform->performAction();
+    visitAction(nodes[currentNode].action, [](auto& action){ action.performAction(); });
+    if(treeToTrack){
+        nodes[currentNode].stateHash = treeToTrack->getStateHash();
+    }
+
+    //Takes a checkpoint every time the interval is reached
+    if(checkpointInterval > 0 && getCurrentStep() % checkpointInterval == 0){
+        takeCheckpoint();
+    }
+
+    spillOldActions();
+
+    visitAction(nodes[currentNode].action, [&](auto& action){
+        recordAutosave(AUTOSAVE_PERFORM, action.getType(), action.getCommandAmount());
+    });
 }
 
 void Timeline::reverseAction(){
-    if(listOfActions.size()>0){
-        //Reverses the last action that was taken
-        listOfActions.back()->reverseAction();
-        //Deallocates the memory
-        delete listOfActions.back();
-        //Deletes the pointer from the vector
-        listOfActions.pop_back();
+    if(currentNode != 0){
+        travelToNode(nodes[currentNode].parent);
+        recordAutosave(AUTOSAVE_REVERSE);
     }else{
         cout << "You can't travel back before the beginning of time" << endl;
     }
 }
 
+void Timeline::redoAction(){
+    if(nodes[currentNode].redoChild != -1){
+        moveToChild(nodes[currentNode].redoChild);
+        recordAutosave(AUTOSAVE_REDO);
+    }else{
+        cout << "There are no reversed actions to redo" << endl;
+    }
+}
+
+void Timeline::travelTo(int step){
+    //Checks that the step is after the beginning of time
+    if(step < 0){
+        cout << "You can't travel back before the beginning of time" << endl;
+        return;
+    }
+
+    int targetNode = currentNode;
+
+    //Steps in the past are found by going back through the timeline
+    while(nodes[targetNode].depth > step){
+        targetNode = nodes[targetNode].parent;
+    }
+
+    //Steps in the future are found by following the actions that would be redone
+    while(nodes[targetNode].depth < step){
+        if(nodes[targetNode].redoChild == -1){
+            cout << "You can't travel to the future" << endl;
+            return;
+        }
+        targetNode = nodes[targetNode].redoChild;
+    }
+
+    travelToNode(targetNode);
+    recordAutosave(AUTOSAVE_TRAVEL, step);
+}
+
+int Timeline::getNumTimelines(){
+    return findTimelineEnds().size();
+}
+
+void Timeline::switchTimeline(int timelineNumber){
+    vector<int> timelineEnds = findTimelineEnds();
+
+    if(timelineNumber < 0 || timelineNumber >= timelineEnds.size()){
+        cout << "Error in Timeline.switchTimeline(), there is no timeline " << timelineNumber << endl;
+        return;
+    }
+
+    travelToNode(timelineEnds[timelineNumber]);
+    recordAutosave(AUTOSAVE_SWITCH, timelineNumber);
+}
+
+void Timeline::printTimelines(){
+    vector<int> timelineEnds = findTimelineEnds();
+
+    //Finds the timeline that a redo would follow from the current node
+    int currentEnd = currentNode;
+    while(nodes[currentEnd].redoChild != -1){
+        currentEnd = nodes[currentEnd].redoChild;
+    }
+
+    for(int i = 0; i < timelineEnds.size(); i++){
+        cout << "Timeline " << i << ": " << nodes[timelineEnds[i]].depth << " actions";
+        if(timelineEnds[i] == currentEnd){
+            cout << " (current, at step " << getCurrentStep() << ")";
+        }
+        cout << endl;
+    }
+}
+
+int Timeline::getCurrentStep(){
+    return nodes[currentNode].depth;
+}
+
+void Timeline::setCheckpointInterval(int stepsBetweenCheckpoints){
+    checkpointInterval = stepsBetweenCheckpoints;
+}
+
+void Timeline::setMemoryBudget(int maxActionsInMemory, string journalPath){
+    //Actions read back from the journal need the tree and player to act on
+    if(treeToTrack == nullptr || playerToTrack == nullptr){
+        cout << "Error in Timeline.setMemoryBudget(), the timeline is not tracking a tree and player" << endl;
+        return;
+    }
+
+    memoryBudget = maxActionsInMemory;
+
+    if(journal == nullptr){
+        journal = new ActionJournal(journalPath);
+    }
+
+    spillOldActions();
+}
+
+void Timeline::travelToNode(int targetNode){
+    //Finds the latest node that is on both the current timeline and the target's timeline
+    int currentAncestor = currentNode;
+    int targetAncestor = targetNode;
+    while(nodes[currentAncestor].depth > nodes[targetAncestor].depth){
+        currentAncestor = nodes[currentAncestor].parent;
+    }
+    while(nodes[targetAncestor].depth > nodes[currentAncestor].depth){
+        targetAncestor = nodes[targetAncestor].parent;
+    }
+    while(currentAncestor != targetAncestor){
+        currentAncestor = nodes[currentAncestor].parent;
+        targetAncestor = nodes[targetAncestor].parent;
+    }
+    int sharedNode = currentAncestor;
+
+    //Remembers which timeline to follow if the actions that are being left are redone
+    for(int node = currentNode; node != sharedNode; node = nodes[node].parent){
+        nodes[nodes[node].parent].redoChild = node;
+    }
+
+    //Finds the latest checkpoint at or before the target
+    int checkpointNode = targetNode;
+    while(checkpointNode != -1 && nodes[checkpointNode].checkpoint == nullptr){
+        checkpointNode = nodes[checkpointNode].parent;
+    }
+
+    //Reversing an action does not always give back the exact state before it, as floats round differently and
+    //supplies are clamped, so travelling back restores a checkpoint and redoes the recorded actions forward.
+    //Travelling forward only restores a checkpoint if it skips some of the actions to redo.
+    if(checkpointNode != -1 && (sharedNode != currentNode || nodes[checkpointNode].depth > nodes[currentNode].depth)){
+        restoreCheckpoint(checkpointNode);
+        currentNode = checkpointNode;
+    }else{
+        //Timelines that are not tracking a tree and player have no checkpoints, so they reverse the actions instead
+        while(currentNode != sharedNode){
+            moveToParent();
+        }
+    }
+
+    //Redoes the actions leading to the target, starting with the earliest
+    vector<int> pathToTarget;
+    for(int node = targetNode; node != currentNode; node = nodes[node].parent){
+        pathToTarget.push_back(node);
+    }
+    for(int i = pathToTarget.size()-1; i >= 0; i--){
+        moveToChild(pathToTarget[i]);
+    }
+
+    //A restored checkpoint skips the actions before it, which are on the target's timeline too
+    for(int node = targetNode; node != sharedNode; node = nodes[node].parent){
+        nodes[nodes[node].parent].redoChild = node;
+    }
+}
+
+void Timeline::moveToParent(){
+    //Reverses the action that led to the current node
+    visitAction(getAction(currentNode), [](auto& action){ action.reverseAction(); });
+
+    //Remembers which timeline to follow if the action is redone
+    int parent = nodes[currentNode].parent;
+    nodes[parent].redoChild = currentNode;
+    currentNode = parent;
+
+    spillOldActions();
+}
+
+void Timeline::moveToChild(int child){
+    //Redoing an action from the same state always records the same data, so any copy in the journal stays valid
+    visitAction(getAction(child), [](auto& action){ action.redoAction(); });
+
+    nodes[currentNode].redoChild = child;
+    currentNode = child;
+
+    spillOldActions();
+}
+
+ActionRecord& Timeline::getAction(int node){
+    //Reads the action back from the journal if it is not in memory
+    if(!hasAction(nodes[node].action) && journal != nullptr && nodes[node].journalPosition != -1){
+        nodes[node].action = journal->read(nodes[node].journalPosition, treeToTrack, playerToTrack);
+
+        nodesInMemory.push_back(node);
+        numActionsInMemory++;
+    }
+
+    return nodes[node].action;
+}
+
+void Timeline::takeCheckpoint(){
+    //Checkpoints can only be taken if the timeline knows about the game state
+    if(treeToTrack == nullptr || playerToTrack == nullptr){
+        return;
+    }
+
+    //The positions are worked out first, as saves can copy checkpoints to other threads
+    treeToTrack->resolvePositions();
+    Checkpoint* checkpoint = new Checkpoint();
+    checkpoint->treeState = new Tree(*treeToTrack);
+    checkpoint->playerState = new Player(*playerToTrack);
+
+    nodes[currentNode].checkpoint = checkpoint;
+}
+
+void Timeline::restoreCheckpoint(int node){
+    //Copies the state into the existing objects, as the actions hold pointers to them.
+    //This takes constant time as the tree shares its branches with the checkpoint.
+    *treeToTrack = *nodes[node].checkpoint->treeState;
+    *playerToTrack = *nodes[node].checkpoint->playerState;
+}
+
+void Timeline::spillOldActions(){
+    if(journal == nullptr || memoryBudget <= 0){
+        return;
+    }
+
+    while(numActionsInMemory > memoryBudget && nodesInMemory.size() > 0){
+        int node = nodesInMemory.front();
+        nodesInMemory.pop_front();
+
+        //Nodes read back from the journal more than once are in the list more than once
+        if(!hasAction(nodes[node].action)){
+            continue;
+        }
+
+        //Actions only need to be written the first time they leave memory
+        if(nodes[node].journalPosition == -1){
+            nodes[node].journalPosition = journal->append(nodes[node].action);
+        }
+
+        nodes[node].action = monostate();
+        numActionsInMemory--;
+    }
+}
+
+void Timeline::enableAutosave(string snapshotPath, string journalPath, int changesBetweenSnapshots){
+    delete autosave;
+    autosave = new AutosaveJournal(snapshotPath, journalPath);
+    autosaveSnapshotInterval = changesBetweenSnapshots;
+
+    saveAutosaveSnapshot();
+}
+
+//Reads a saved action, which is an array of the given number of integers followed by its amount.
+//The last integer is the type of the action.
+static void readSavedAction(JsonReader& reader, int* integers, int numIntegers, float& amount){
+    reader.beginArray();
+    for(int i = 0; i < numIntegers; i++){
+        if(!reader.nextElement()){
+            reader.fail("expected " + to_string(numIntegers+1) + " values in the action");
+        }
+        integers[i] = reader.readInt();
+    }
+
+    int type = integers[numIntegers-1];
+    if(type < WATER_ACTION || type > PRUNE_ACTION){
+        reader.fail("unknown action type " + to_string(type));
+    }
+
+    if(!reader.nextElement()){
+        reader.fail("expected the amount of the action");
+    }
+    amount = reader.readFloat();
+    if(reader.nextElement()){
+        reader.fail("expected the end of the action");
+    }
+}
+
+bool Timeline::recoverAutosave(string snapshotPath, string journalPath){
+    ifstream file(snapshotPath, ios::binary);
+    if(!file.is_open()){
+        return false;
+    }
+
+    if(nodes.size() > 1){
+        cout << "Error in Timeline.recoverAutosave(), the timeline already has actions" << endl;
+        return false;
+    }
+
+    //Reads the whole snapshot before anything is changed, so a damaged snapshot leaves the timeline as it was
+    unique_ptr<Tree> startTree;
+    unique_ptr<Tree> currentTree;
+    Player startPlayer(0, 0);
+    Player currentPlayer(0, 0);
+    vector<int> parents;
+    vector<pair<ActionType, float>> actions;
+    vector<int> redoChildren;
+    int savedNode = -1;
+    unsigned int generation = 0;
+    try {
+        JsonReader reader(file);
+        string key;
+        reader.beginObject();
+        while(reader.nextKey(key)){
+            if(key == "generation"){
+                generation = reader.readUnsigned();
+            }else if(key == "startTree"){
+                startTree.reset(Tree::readJson(reader));
+            }else if(key == "startPlayer"){
+                startPlayer = Player::readJson(reader);
+            }else if(key == "actions"){
+                reader.beginArray();
+                while(reader.nextElement()){
+                    int parentAndType[2];
+                    float amount;
+                    readSavedAction(reader, parentAndType, 2, amount);
+                    parents.push_back(parentAndType[0]);
+                    actions.push_back(make_pair((ActionType)parentAndType[1], amount));
+                }
+            }else if(key == "redoChildren"){
+                reader.beginArray();
+                while(reader.nextElement()){
+                    redoChildren.push_back(reader.readInt());
+                }
+            }else if(key == "currentNode"){
+                savedNode = reader.readInt();
+            }else if(key == "currentTree"){
+                currentTree.reset(Tree::readJson(reader));
+            }else if(key == "currentPlayer"){
+                currentPlayer = Player::readJson(reader);
+            }else{
+                reader.skipValue();
+            }
+        }
+        reader.endDocument();
+
+        if(startTree == nullptr || currentTree == nullptr){
+            reader.fail("the snapshot does not have a start tree and a current tree");
+        }
+    } catch (JsonReadError& e) {
+        cout << "Error in Timeline.recoverAutosave(), could not read " << snapshotPath << ": " << e.what() << endl;
+        return false;
+    }
+
+    //Starts from the saved start of time, which replaces the checkpoint of the previous start
+    *treeToTrack = *startTree;
+    *playerToTrack = startPlayer;
+    delete nodes[0].checkpoint->treeState;
+    delete nodes[0].checkpoint->playerState;
+    delete nodes[0].checkpoint;
+    takeCheckpoint();
+    nodes[0].stateHash = treeToTrack->getStateHash();
+
+    //Performs every action again after its parent, which gives every node the same number as before
+    for(int i = 0; i < actions.size(); i++){
+        if(parents[i] < 0 || parents[i] >= nodes.size()){
+            cout << "Error in Timeline.recoverAutosave(), action " << i << " has an invalid parent" << endl;
+            break;
+        }
+        travelToNode(parents[i]);
+        performAction(createAction(actions[i].first, actions[i].second, treeToTrack, playerToTrack));
+    }
+
+    for(int i = 0; i < nodes.size() && i < redoChildren.size(); i++){
+        nodes[i].redoChild = redoChildren[i];
+    }
+
+    if(savedNode >= 0 && savedNode < nodes.size()){
+        travelToNode(savedNode);
+    }
+
+    //Uses the exact saved state, as redoing actions by a different route can round floats differently
+    *treeToTrack = *currentTree;
+    *playerToTrack = currentPlayer;
+
+    //Replays the changes that were made after the snapshot was taken
+    autosaveGeneration = generation;
+    vector<AutosaveRecord> records = AutosaveJournal::readRecords(journalPath, autosaveGeneration);
+    for(int i = 0; i < records.size(); i++){
+        applyAutosaveRecord(records[i]);
+    }
+
+    return true;
+}
+
+void Timeline::recordAutosave(AutosaveOperation operation, int value, float amount){
+    if(autosave == nullptr){
+        return;
+    }
+
+    autosave->append({operation, value, amount});
+
+    if(autosave->getNumRecords() >= autosaveSnapshotInterval){
+        saveAutosaveSnapshot();
+    }
+}
+
+void Timeline::writeAutosaveSnapshot(JsonWriter& writer){
+    writer.beginObject();
+    writer.field("generation", autosaveGeneration);
+    writer.key("startTree");
+    nodes[0].checkpoint->treeState->writeJson(writer);
+    writer.key("startPlayer");
+    nodes[0].checkpoint->playerState->writeJson(writer);
+
+    //Nodes are stored in the order they were created, so every parent is before its children
+    writer.key("actions");
+    writer.beginArray();
+    for(int node = 1; node < nodes.size(); node++){
+        visitAction(getAction(node), [&](auto& action){
+            writer.beginArray();
+            writer.value(nodes[node].parent);
+            writer.value((int)action.getType());
+            writer.value(action.getCommandAmount());
+            writer.endArray();
+        });
+    }
+    writer.endArray();
+
+    writer.key("redoChildren");
+    writer.beginArray();
+    for(int node = 0; node < nodes.size(); node++){
+        writer.value(nodes[node].redoChild);
+    }
+    writer.endArray();
+
+    writer.field("currentNode", currentNode);
+    writer.key("currentTree");
+    treeToTrack->writeJson(writer);
+    writer.key("currentPlayer");
+    playerToTrack->writeJson(writer);
+    writer.endObject();
+}
+
+void Timeline::saveAutosaveSnapshot(){
+    autosaveGeneration++;
+
+    ofstream file(autosave->getNewSnapshotPath());
+    {
+        JsonWriter writer(file);
+        writeAutosaveSnapshot(writer);
+    }
+    file.close();
+
+    if(!file){
+        cout << "Error in Timeline.saveAutosaveSnapshot(), could not write " << autosave->getNewSnapshotPath() << endl;
+        return;
+    }
+
+    autosave->commitSnapshot(autosaveGeneration);
+}
+
+void Timeline::applyAutosaveRecord(const AutosaveRecord& record){
+    switch(record.operation){
+    case AUTOSAVE_PERFORM:
+        performAction(createAction((ActionType)record.value, record.amount, treeToTrack, playerToTrack));
+        break;
+    case AUTOSAVE_REVERSE:
+        reverseAction();
+        break;
+    case AUTOSAVE_REDO:
+        redoAction();
+        break;
+    case AUTOSAVE_TRAVEL:
+        travelTo(record.value);
+        break;
+    case AUTOSAVE_SWITCH:
+        switchTimeline(record.value);
+        break;
+    }
+}
+
+vector<int> Timeline::findCurrentPath(){
+    vector<int> path;
+    for (int node = currentNode; node != 0; node = nodes[node].parent){
+        path.push_back(node);
+    }
+    reverse(path.begin(), path.end());
+
+    return path;
+}
+
+vector<unsigned int> Timeline::getStateHashes(){
+    vector<unsigned int> hashes = {nodes[0].stateHash};
+    vector<int> path = findCurrentPath();
+    for (int i = 0; i < path.size(); i++){
+        hashes.push_back(nodes[path[i]].stateHash);
+    }
+
+    return hashes;
+}
+
+vector<int> Timeline::findTimelineEnds(){
+    vector<int> timelineEnds;
+    for(int i = 0; i < nodes.size(); i++){
+        if(nodes[i].children.size() == 0){
+            timelineEnds.push_back(i);
+        }
+    }
+
+    return timelineEnds;
+}
+
+void Timeline::writeJson(JsonWriter& writer){
+    getSave().writeJson(writer);
+}
+
+TimelineSave Timeline::getSave(){
+    TimelineSave save = {*nodes[0].checkpoint->treeState, *nodes[0].checkpoint->playerState};
+
+    vector<int> path = findCurrentPath();
+    for (int i = 0; i < path.size(); i++){
+        visitAction(getAction(path[i]), [&](auto& action){
+            save.commands.push_back(make_pair(action.getType(), action.getCommandAmount()));
+        });
+    }
+
+    return save;
+}
+
+void TimelineSave::writeJson(JsonWriter& writer) const {
+    writer.beginObject();
+    writer.key("startTree");
+    startTree.writeJson(writer);
+    writer.key("startPlayer");
+    startPlayer.writeJson(writer);
+
+    writer.key("commands");
+    writer.beginArray();
+    for (int i = 0; i < commands.size(); i++){
+        writer.beginArray();
+        writer.value((int)commands[i].first);
+        writer.value(commands[i].second);
+        writer.endArray();
+    }
+    writer.endArray();
+    writer.endObject();
+}
+
+TimelineSave TimelineSave::readJson(JsonReader& reader){
+    unique_ptr<Tree> startTree;
+    Player startPlayer(0, 0);
+    vector<pair<ActionType, float>> commands;
+
+    string key;
+    reader.beginObject();
+    while(reader.nextKey(key)){
+        if(key == "startTree"){
+            startTree.reset(Tree::readJson(reader));
+        }else if(key == "startPlayer"){
+            startPlayer = Player::readJson(reader);
+        }else if(key == "commands"){
+            //Each command is an array of its type and amount
+            reader.beginArray();
+            while(reader.nextElement()){
+                int type;
+                float amount;
+                readSavedAction(reader, &type, 1, amount);
+                commands.push_back(make_pair((ActionType)type, amount));
+            }
+        }else{
+            reader.skipValue();
+        }
+    }
+
+    if(startTree == nullptr){
+        reader.fail("the timeline has no start tree");
+    }
+    return {*startTree, startPlayer, commands};
+}
+
+void Timeline::replayCommands(const vector<pair<ActionType, float>>& commands){
+    for (int i = 0; i < commands.size(); i++){
+        performAction(createAction(commands[i].first, commands[i].second, treeToTrack, playerToTrack));
+    }
+}
+
 void Timeline::printData(){
     cout << "Timeline of all actions" << endl;
-    cout << "List of all actions: " << endl; 
-    for (int i = 0; i < listOfActions.size(); i++){
-        cout << listOfActions[i] << ", "; 
-    } 
+    cout << "Number of actions in all timelines: " << nodes.size()-1 << endl;
+    cout << "Actions in memory: " << numActionsInMemory << endl;
+    printTimelines();
+
+    cout << "Checkpoint interval: " << checkpointInterval << endl;
+    cout << "Steps with checkpoints on the current timeline: " << endl;
+    for (int node = currentNode; node != -1; node = nodes[node].parent){
+        if(nodes[node].checkpoint != nullptr){
+            cout << nodes[node].depth << ", ";
+        }
+    }
     cout << endl;
 }
@@ -4,22 +4,192 @@
 
 #include "Printable.h"
 #include <vector>
-#include "Action.h"
+#include <deque>
+#include <string>
+#include "ActionRecord.h"
+#include "ActionJournal.h"
+#include "AutosaveJournal.h"
+#include "Tree.h"
+#include "Player.h"
 
 
 using namespace std;
 
+//Default number of actions between full copies of the game state
+const int DEFAULT_CHECKPOINT_INTERVAL = 10;
+
+//Default number of autosave records between snapshots of the whole timeline
+const int DEFAULT_AUTOSAVE_SNAPSHOT_INTERVAL = 100;
+
+//The start of a timeline and the commands on its current path, which is all that compact saves store.
+//The tree shares its branches with the game, so taking a save is cheap and it does not change afterwards.
+struct TimelineSave {
+    Tree startTree;
+    Player startPlayer;
+
+    //The type and amount of each action, from the first action to the current one
+    vector<pair<ActionType, float>> commands;
+
+    //Writes the same JSON as Timeline::writeJson()
+    void writeJson(JsonWriter& writer) const;
+    //Reads a save written by writeJson(), throwing a JsonReadError if it is not valid
+    static TimelineSave readJson(JsonReader& reader);
+};
+
+//Stores every action that has been performed as a tree of timelines.
+//Reversing an action keeps it so that it can be redone, and performing a new action after reversing
+//starts a new timeline that shares all of the actions before it with the old one.
 class Timeline : public Printable{
     public:
         Timeline();
+        //Creates a timeline that takes checkpoints of the given tree and player
+        Timeline(Tree* currentTree, Player* currentPlayer, int stepsBetweenCheckpoints = DEFAULT_CHECKPOINT_INTERVAL);
         ~Timeline();
 
-        void performAction(Action* actionToPerform);
+        void performAction(ActionRecord actionToPerform);
         void reverseAction();
+
+        //Performs the most recently reversed action again
+        void redoAction();
+
+        //Travels to the state after the given number of actions on the current timeline, where 0 is the
+        //start of the timeline. Steps after the current one redo reversed actions.
+        void travelTo(int step);
+
+        //Returns the number of timelines, which is the number of actions that have no actions after them
+        int getNumTimelines();
+
+        //Travels to the last action of the given timeline
+        void switchTimeline(int timelineNumber);
+
+        //Prints the length of each timeline
+        void printTimelines();
+
+        //Returns the number of actions that have been performed on the current timeline
+        int getCurrentStep();
+
+        //Returns the state hash of the tree at the start of time and after each action on the current timeline,
+        //as it was when the action was first performed. Two runs that give the same hashes grew the same tree.
+        vector<unsigned int> getStateHashes();
+
+        //Sets how many actions are performed between checkpoints, trading memory for travel speed
+        void setCheckpointInterval(int stepsBetweenCheckpoints);
+
+        //Limits the number of actions kept in memory, with other actions written to a journal file.
+        //A limit of 0 keeps every action in memory.
+        void setMemoryBudget(int maxActionsInMemory, string journalPath = "timeline.journal");
+
+        //Writes the state at the start of time and the type and amount of every action on the current
+        //timeline, which is much smaller than saving the whole tree
+        void writeJson(JsonWriter& writer);
+
+        //Copies everything that writeJson() writes, so that it can be written later or on another thread
+        TimelineSave getSave();
+
+        //Records every change to the timeline in an autosave journal, which is compacted into a snapshot of the
+        //whole timeline after the given number of changes. A snapshot is taken straight away.
+        void enableAutosave(string snapshotPath, string journalPath, int changesBetweenSnapshots = DEFAULT_AUTOSAVE_SNAPSHOT_INTERVAL);
+
+        //Rebuilds the timeline and the game state from an autosave snapshot and the changes recorded after it.
+        //The timeline must not have any actions yet. Returns false if there is no autosave to recover.
+        bool recoverAutosave(string snapshotPath, string journalPath);
+
+        //Performs every command from a saved timeline, which must start from the same state as this timeline
+        void replayCommands(const vector<pair<ActionType, float>>& commands);
+
         void printData();
 
     private:
-        vector<Action*> listOfActions;
+        //A copy of the game state, which shares any unchanged branches with the current tree
+        struct Checkpoint {
+            Tree* treeState;
+            Player* playerState;
+        };
+
+        //An action in the tree of timelines
+        struct TimelineNode {
+            //The action that leads to this node, which is empty for the start of time and for actions in the journal
+            ActionRecord action;
+
+            //Position of the action in the journal, or -1 if it has not been written to the journal
+            streamoff journalPosition;
+
+            int parent;
+            vector<int> children;
+
+            //The child that a redo moves to, or -1 if there is none
+            int redoChild;
+
+            //Number of actions between the start of time and this node
+            int depth;
+
+            //State hash of the tree straight after the action was first performed
+            unsigned int stateHash;
+
+            //Copy of the state after the action, or nullptr if no checkpoint was taken
+            Checkpoint* checkpoint;
+        };
+
+        //Moves to any node by restoring the latest checkpoint before it and redoing actions forward, so that the
+        //state is exactly the same as when the actions were performed
+        void travelToNode(int targetNode);
+
+        //Reverses the action of the current node, which is only used when there is no checkpoint to restore
+        void moveToParent();
+
+        //Redoes the action of a child of the current node
+        void moveToChild(int child);
+
+        //Returns the action of a node, reading it back from the journal if necessary
+        ActionRecord& getAction(int node);
+
+        //Copies the current state of the tree and player into a checkpoint at the current node
+        void takeCheckpoint();
+
+        //Overwrites the tree and player with the state stored at a node
+        void restoreCheckpoint(int node);
+
+        //Moves the least recently used actions to the journal while there are too many in memory
+        void spillOldActions();
+
+        //Adds a change to the autosave journal, taking a new snapshot if enough changes have been recorded
+        void recordAutosave(AutosaveOperation operation, int value = 0, float amount = 0);
+
+        //Writes every node, the current node and the current state, so that the timeline can be rebuilt exactly
+        void writeAutosaveSnapshot(JsonWriter& writer);
+        void saveAutosaveSnapshot();
+
+        //Makes the change stored in an autosave record again
+        void applyAutosaveRecord(const AutosaveRecord& record);
+
+        //Returns the nodes from the first action to the current node
+        vector<int> findCurrentPath();
+
+        //Returns the last node of every timeline, in the order that they were created
+        vector<int> findTimelineEnds();
+
+        //Every node in the tree of timelines, where the first node is the start of time.
+        //Actions are stored inside the nodes, so they are not allocated separately.
+        vector<TimelineNode> nodes;
+        int currentNode;
+
+        //Nodes whose actions are in memory, least recently used first
+        deque<int> nodesInMemory;
+        int numActionsInMemory;
+
+        ActionJournal* journal;
+        int memoryBudget;
+
+        Tree* treeToTrack;
+        Player* playerToTrack;
+
+        int checkpointInterval;
+
+        //The autosave journal, or nullptr if autosaving is off
+        AutosaveJournal* autosave;
+        int autosaveSnapshotInterval;
+        //Increases with every snapshot, so a journal is only replayed on top of its own snapshot
+        unsigned int autosaveGeneration;
 };
 
-#endif
\ No newline at end of file
+#endif
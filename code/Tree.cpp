@@ -1,40 +1,108 @@
 #include "Tree.h"
+#include "SaveFormat.h"
+#include <cstring>
+#include <cmath>
+#include <memory>
+
+//Width of the cells in the grid used to find the branches that a new branch could overlap, which is about the length
+//of a new branch
+const float OVERLAP_CELL_SIZE = 50;
+
+//The growth parameters that are numbers with their names in JSON saves, in the order they are stored in binary and
+//packed saves. The growth law and supply model are stored after them as integers.
+const pair<const char*, float GrowthConfig::*> SAVED_GROWTH_PARAMETERS[] = {
+    {"newBranchThreshold", &GrowthConfig::newBranchThreshold},
+    {"newBranchRequirement", &GrowthConfig::newBranchRequirement},
+    {"branchGrowthAmount", &GrowthConfig::branchGrowthAmount},
+    {"newBranchProbability", &GrowthConfig::newBranchProbability},
+    {"lengthGrowthRatio", &GrowthConfig::lengthGrowthRatio},
+    {"supplyUsedPerGrowth", &GrowthConfig::supplyUsedPerGrowth},
+    {"areaPerSupply", &GrowthConfig::areaPerSupply},
+    {"sproutAttempts", &GrowthConfig::sproutAttempts},
+};
+
+//Number of bytes that a growth config takes in binary and packed saves
+const size_t SAVED_GROWTH_CONFIG_SIZE = (size(SAVED_GROWTH_PARAMETERS) + 2)*4;
+
+//Writes a growth config to a binary or packed save
+static void writeGrowthConfig(ostream& stream, const GrowthConfig& config){
+    for(const auto& parameter : SAVED_GROWTH_PARAMETERS){
+        writeValue(stream, config.*parameter.second);
+    }
+    writeValue(stream, (int)config.growthLaw);
+    writeValue(stream, (int)config.supplyModel);
+}
 
-//Maximum area of a branch before it will no longer sprout new branches
-const float NEW_BRANCH_THRESHOLD = 5000;
-
-
-//Required nutrients and water for a new branch to grow
-const float NEW_BRANCH_REQUIREMENT = 3;
+//Reads a growth config written by writeGrowthConfig(), returning false if the data ends first or the growth law
+//or supply model is not one that trees can grow with
+static bool readGrowthConfig(const char*& position, const char* end, GrowthConfig& config){
+    for(const auto& parameter : SAVED_GROWTH_PARAMETERS){
+        if(!readValue(position, end, config.*parameter.second)){
+            return false;
+        }
+    }
 
-//Scales the amount that branches grow by with a given amount of food
-const float BRANCH_GROWTH_AMOUNT = 50;
+    int growthLaw, supplyModel;
+    if(!readValue(position, end, growthLaw) || !readValue(position, end, supplyModel) ||
+       growthLaw < QUADRATIC_GROWTH || growthLaw > LOGISTIC_GROWTH || supplyModel < EVEN_SUPPLY || supplyModel > VASCULAR_SUPPLY){
+        return false;
+    }
+    config.growthLaw = (GrowthLaw)growthLaw;
+    config.supplyModel = (SupplyModel)supplyModel;
+    return true;
+}
 
-//Chance of each existing branch growing a new branch
-const float NEW_BRANCH_PROBABILITY = 0.4;
+//Reads a growth config written by Tree::writeJson(). Parameters that are missing keep their default values.
+static GrowthConfig readGrowthConfig(JsonReader& reader){
+    GrowthConfig config;
+    string key;
+    reader.beginObject();
+    while (reader.nextKey(key)) {
+        bool found = false;
+        for (const auto& parameter : SAVED_GROWTH_PARAMETERS) {
+            if (key == parameter.first) {
+                config.*parameter.second = reader.readFloat();
+                found = true;
+            }
+        }
 
+        if (found) {
+            continue;
+        } else if (key == "growthLaw") {
+            int growthLaw = reader.readInt();
+            if (growthLaw < QUADRATIC_GROWTH || growthLaw > LOGISTIC_GROWTH) {
+                reader.fail("unknown growth law " + to_string(growthLaw));
+            }
+            config.growthLaw = (GrowthLaw)growthLaw;
+        } else if (key == "supplyModel") {
+            int supplyModel = reader.readInt();
+            if (supplyModel < EVEN_SUPPLY || supplyModel > VASCULAR_SUPPLY) {
+                reader.fail("unknown supply model " + to_string(supplyModel));
+            }
+            config.supplyModel = (SupplyModel)supplyModel;
+        } else {
+            reader.skipValue();
+        }
+    }
+    return config;
+}
 
-Tree::Tree(float initialWater, float initialNutrients, Branch* trunk): waterLevel(initialWater), 
-nutrientLevel(initialNutrients), maxIndex(1) {
-    //Adds the trunk as the first branch in the list
-    branchList.push_back(trunk);
+Tree::Tree(float initialWater, float initialNutrients, Branch* trunk, unsigned int seed): waterLevel(initialWater), 
+nutrientLevel(initialNutrients), maxIndex(1), randomState(seed), branchHash(0) {
+    //Adds the trunk as the first branch in the list, and frees the trunk as the tree stores its own copy
+    appendBranch(*trunk);
+    delete trunk;
 
-    //sets a seed for randomly generated numbers
-    long int t = static_cast<long int> (time(NULL));
-    srand(t);
+    //The random state can never be zero, as the generator would only produce zeroes
+    if(randomState == 0){
+        randomState = 1;
+    }
 
     //Updates the max water and nutrients of the tree
     updateMaxConstraints();
 
 }
 
-Tree::~Tree(){
-    //Deletes all of the branches
-    for(int i = 0; i < branchList.size(); i++){
-        delete branchList[i];
-    }
-}
-
 float Tree::addWater(float litres){
     //Checks whether the tree has the capacity to absorb the given amount of water
     if(litres+waterLevel >= maxWater){
@@ -81,11 +149,15 @@ void Tree::removeNutrients(float kilograms){
     nutrientLevel -= kilograms;
 }
 
-void Tree::addBranches(vector<Branch*> newBranches){
+void Tree::addBranches(vector<Branch> newBranches){
     //Adds the additional branches to the tree
     for(int i = 0; i < newBranches.size(); i++){
-        branchList.push_back(newBranches[i]);
+        appendBranch(newBranches[i]);
+
+        //Makes sure that branches grown later do not reuse the index
+        maxIndex = max(maxIndex, newBranches[i].getIndex()+1);
     }
+    allBranchesResupplied = true;
 
     //Updates the max water and nutrients of the tree
     updateMaxConstraints();
@@ -93,132 +165,246 @@ void Tree::addBranches(vector<Branch*> newBranches){
 
 void Tree::grow(float &waterConsumed, float &nutrientsConsumed, 
     vector<float> &widthIncreases, vector<float> &lengthIncreases, vector<int> &branchesGrown){
+    //The law is picked once here, so the loop over the branches is compiled separately for each one
+    switch(growthConfig.growthLaw){
+    case LINEAR_GROWTH:
+        growWith<LinearGrowth>(waterConsumed, nutrientsConsumed, widthIncreases, lengthIncreases, branchesGrown);
+        break;
+    case LOGISTIC_GROWTH:
+        growWith<LogisticGrowth<>>(waterConsumed, nutrientsConsumed, widthIncreases, lengthIncreases, branchesGrown);
+        break;
+    default:
+        growWith<QuadraticGrowth>(waterConsumed, nutrientsConsumed, widthIncreases, lengthIncreases, branchesGrown);
+        break;
+    }
+}
+
+template <typename GrowthPolicy>
+void Tree::growWith(float &waterConsumed, float &nutrientsConsumed,
+    vector<float> &widthIncreases, vector<float> &lengthIncreases, vector<int> &branchesGrown){
 
     //Finds the growth amount of each branch based on the amount of water and nutrients
     float growthAmount = min(waterLevel, nutrientLevel);
-    float branchGrowthAmount = BRANCH_GROWTH_AMOUNT*growthAmount/branchList.size();
+    float branchGrowthAmount = growthConfig.branchGrowthAmount*growthAmount/branchList.size();
+
+    //With vascular supply, each branch gets its share of the total instead
+    float totalGrowthAmount = growthConfig.branchGrowthAmount*growthAmount;
+    bool vascularSupply = growthConfig.supplyModel == VASCULAR_SUPPLY;
+    if(vascularSupply){
+        resolveSupply();
+    }
 
 
     //Removes water and nutrients based on the size of the tree
-    waterLevel-= maxWater*0.05;
-    nutrientLevel-= maxNutrients*0.05;
+    waterLevel-= maxWater*growthConfig.supplyUsedPerGrowth;
+    nutrientLevel-= maxNutrients*growthConfig.supplyUsedPerGrowth;
 
     //Updates output variables based on the amount of water and nutrients consumed
-    waterConsumed = maxWater*0.05;
-    nutrientsConsumed = maxNutrients*0.05;
+    waterConsumed = maxWater*growthConfig.supplyUsedPerGrowth;
+    nutrientsConsumed = maxNutrients*growthConfig.supplyUsedPerGrowth;
 
     int currentNumBranches = branchList.size();
 
+    //New branches are checked against the branches around them where they were at the start of the growth, which
+    //are found with a grid so that each check only looks at a few branches however large the tree is
+    bool avoidOverlap = growthConfig.sproutAttempts >= 1;
+    SpatialHash branchGrid(OVERLAP_CELL_SIZE);
+    auto addToGrid = [&](int position){
+        Point2f minCorner, maxCorner;
+        branchList[position].getBounds(minCorner, maxCorner);
+        branchGrid.insert(position, minCorner.x, minCorner.y, maxCorner.x, maxCorner.y);
+    };
+    if(avoidOverlap){
+        resolvePositions();
+        for(int i = 0; i < currentNumBranches; i++){
+            addToGrid(i);
+        }
+    }
+
     for(int branchIndex = 0; branchIndex < currentNumBranches; branchIndex++){
 
         float widthGrowth;
         float lengthGrowth;
+        float growthAmount = branchGrowthAmount;
+        if(vascularSupply){
+            growthAmount = totalGrowthAmount*branchSupplies[branchList[branchIndex].getIndex()].share;
+        }
 
-        //Grows the branch by the calculated amount
-        branchList[branchIndex]->grow(branchGrowthAmount, widthGrowth, lengthGrowth);
+        //Grows the branch by the calculated amount. Every branch changes, so the hash of the branches is worked out
+        //again by branchesResized() at the end.
+        branchList.modify(branchIndex).grow<GrowthPolicy>(growthAmount, growthConfig, widthGrowth, lengthGrowth);
 
 
         //Adds the growth amounts to the corresponding lists
         widthIncreases.push_back(widthGrowth);
         lengthIncreases.push_back(lengthGrowth);
 
-        //Moves all of the child branches in accordance with the branch's growth
-        //Gets children of current branch
-        vector<int> childIndices = branchList[branchIndex]->getChildren();
-
         //Gets new position of the tip of the current branch
         float newTipX;
         float newTipY;
-        branchList[branchIndex]->getTipPos(newTipX, newTipY);
+        branchList[branchIndex].getTipPos(newTipX, newTipY);
 
 
         //Adds a new branch if the tree has the required nutrients and water
-        if(min(nutrientLevel, waterLevel) > NEW_BRANCH_REQUIREMENT && 
-        branchList[branchIndex]->getSize() < NEW_BRANCH_THRESHOLD &&
-        (float)rand()/RAND_MAX < NEW_BRANCH_PROBABILITY){
+        if(min(nutrientLevel, waterLevel) > growthConfig.newBranchRequirement && 
+        branchList[branchIndex].getSize() < growthConfig.newBranchThreshold &&
+        randomFraction() < growthConfig.newBranchProbability){
 
             //Gets the angle of the current branch
-            float currentBranchAngle = branchList[branchIndex]->getAngle();
+            float currentBranchAngle = branchList[branchIndex].getAngle();
 
             //Generates a random number between -70 and 70
-            float newAngle = 140*((float)(rand()) /RAND_MAX-0.5);
-            Branch* newBranch = new Branch(maxIndex, branchList[branchIndex]->getIndex(), newAngle, 50, 10, newTipX, newTipY);
-            branchList.push_back(newBranch);
-
-            //Adds the new branch index to the list of new branches grown
-            branchesGrown.push_back(maxIndex);
-           
-            branchList[branchIndex]->addChild(maxIndex);
-            
-            //Increments the highest index
-            maxIndex++;
+            float newAngle = 140*(randomFraction()-0.5);
+            Branch newBranch(maxIndex, branchList[branchIndex].getIndex(), newAngle, 50, 10, newTipX, newTipY);
+
+            //Tries other angles while the new branch would overlap another branch, and gives up on it if they all do
+            bool sprouted = true;
+            if(avoidOverlap){
+                sprouted = !overlapsBranches(newBranch, branchIndex, branchGrid);
+                for(int attempt = 1; !sprouted && attempt < growthConfig.sproutAttempts; attempt++){
+                    newAngle = 140*(randomFraction()-0.5);
+                    newBranch = Branch(maxIndex, branchList[branchIndex].getIndex(), newAngle, 50, 10, newTipX, newTipY);
+                    sprouted = !overlapsBranches(newBranch, branchIndex, branchGrid);
+                }
+            }
+
+            if(sprouted){
+                appendBranch(newBranch);
+                if(avoidOverlap){
+                    addToGrid(branchList.size()-1);
+                }
+
+                //Adds the new branch index to the list of new branches grown
+                branchesGrown.push_back(maxIndex);
+
+                branchList.modify(branchIndex).addChild(maxIndex);
+
+                //Increments the highest index
+                maxIndex++;
+            }
         }
 
     }
 
-    //Updates positions of branches
-    updateBranchPos();
+    //The branches are moved to the tips of their parents once they are needed
+    branchesResized();
 
     //Updates the max water and nutrients of the tree
     updateMaxConstraints();
 
 }
 
-void Tree::pruneBranch(int branchIndex, vector<Branch*> &removedBranches) {
-
-    if(findBranch(branchIndex) == -1){
-        printData();
+void Tree::pruneBranch(int branchIndex, DetachedBranches &removedBranches) {
+    int position = findBranch(branchIndex);
+    if(position == -1){
+        cout << "Error in Tree.pruneBranch(), branch with index " << branchIndex << " is not in the tree" << endl;
+        return;
     }
 
-    //Gets children of branch
-    vector<int> childIndices = branchList[findBranch(branchIndex)]->getChildren();
+    removedBranches.branches.clear();
+    removedBranches.listPositions.clear();
+    removedBranches.positionInParent = -1;
 
-    vector<Branch*> prunedBranches;
+    //Detaches the branch from its parent, remembering where it was so the order of the children can be restored
+    supplyChanged(position);
+    int parentPosition = findBranch(branchList[position].getParentIndex());
+    if(parentPosition != -1){
+        removedBranches.positionInParent = branchList[parentPosition].getChildPosition(branchIndex);
+        changeBranch(parentPosition, [branchIndex](Branch& branch){ branch.removeChild(branchIndex); });
+    }
 
-    prunedBranches.push_back(branchList[findBranch(branchIndex)]);
-
-    
-    vector<int> removeIndices = {branchIndex};
+    //Removes the subtree by following the child links, so only the branches being removed are visited
+    vector<int> branchesToRemove = {branchIndex};
+    while(!branchesToRemove.empty()){
+        int index = branchesToRemove.back();
+        branchesToRemove.pop_back();
 
+        position = findBranch(index);
+        if(position == -1){
+            continue;
+        }
 
-    //Removes branch from tree
-    removeBranches(removeIndices);
+        //Children are added in reverse so that they are removed in the same order as they are stored
+        vector<int> childIndices = branchList[position].getChildren();
+        for(int i = childIndices.size()-1; i >= 0; i--){
+            branchesToRemove.push_back(childIndices[i]);
+        }
 
-    vector<Branch*> prunedChildren;
+        removedBranches.branches.push_back(branchList[position]);
+        removedBranches.listPositions.push_back(position);
+        removeBranchAt(position);
+    }
 
-    //Loops through the branch's children
-    for(int i = 0; i < childIndices.size(); i++){
+    //Updates the max water and nutrients of the tree
+    updateMaxConstraints();
+}
 
-        //Prunes child of branch
-        pruneBranch(childIndices[i], prunedChildren);
-        //Adds pruned children to list
-        for(int j = 0; j < prunedChildren.size(); j++){
-            prunedBranches.push_back(prunedChildren[j]);
+void Tree::restoreBranches(const DetachedBranches &removedBranches){
+    //Undoes each removal in reverse order, so every branch ends up back in its original position
+    for(int i = removedBranches.branches.size()-1; i >= 0; i--){
+        const Branch& branch = removedBranches.branches[i];
+        int position = removedBranches.listPositions[i];
+
+        if(position >= branchList.size()){
+            appendBranch(branch);
+        }else{
+            //Moves the branch that took its place back to the end of the list. It is copied first, as adding to
+            //the list can move the branches stored in it
+            Branch movedBranch = branchList[position];
+            appendBranch(movedBranch);
+            changeBranch(position, [&](Branch& oldBranch){ oldBranch = branch; });
+            setBranchPosition(branch.getIndex(), position);
         }
-        
-        prunedChildren.clear();
+
+        //Makes sure that branches grown later do not reuse the index
+        maxIndex = max(maxIndex, branch.getIndex()+1);
     }
 
-    removedBranches = prunedBranches;
+    //Reattaches the subtree to its parent in the same place among the other children
+    if(!removedBranches.branches.empty()){
+        const Branch& prunedBranch = removedBranches.branches[0];
+        supplyChanged(removedBranches.listPositions[0]);
+        int parentPosition = findBranch(prunedBranch.getParentIndex());
+        if(parentPosition != -1){
+            changeBranch(parentPosition, [&](Branch& parent){
+                parent.insertChild(prunedBranch.getIndex(), removedBranches.positionInParent);
+            });
+
+            //The parent may have grown since the subtree was cut off, so only the subtree needs to be moved
+            if(!allBranchesMoved){
+                movedBranches.push_back(prunedBranch.getParentIndex());
+            }
+        }
+    }
 
+    //Updates the max water and nutrients of the tree
+    updateMaxConstraints();
 }
 
 void Tree::removeBranches(vector<int> branchIndices){
-    //Loops through given list of branches
-    for(int i = 0; i < branchIndices.size(); i++){
+    //Loops through given list of branches from the last to the first, so that the newest branches
+    //are taken off the end of the list without moving any others
+    for(int i = branchIndices.size()-1; i >= 0; i--){
+        int position = findBranch(branchIndices[i]);
+        if(position == -1){
+            continue;
+        }
+
         //Removes the branch from its parent's list of children
-        int parentIndex = branchList[findBranch(branchIndices[i])]->getParentIndex();
-        
-        int parentLocation = findBranch(parentIndex);
+        supplyChanged(position);
+        int parentPosition = findBranch(branchList[position].getParentIndex());
 
-        if(parentLocation >= 0){
-            branchList[parentLocation]->removeChild(branchIndices[i]);
+        if(parentPosition >= 0){
+            changeBranch(parentPosition, [&](Branch& parent){ parent.removeChild(branchIndices[i]); });
         }
 
-        
         //Removes the branch itself
-        branchList.erase(branchList.begin()+findBranch(branchIndices[i]));
+        removeBranchAt(position);
+    }
 
+    //Gives back the newest indices, so branches grown after an undo get the same indices as before
+    while(find(branchIndices.begin(), branchIndices.end(), maxIndex-1) != branchIndices.end()){
+        maxIndex--;
     }
 
     //Updates the max water and nutrients of the tree
@@ -226,6 +412,35 @@ void Tree::removeBranches(vector<int> branchIndices){
 
 }
 
+void Tree::regrowBranches(vector<float> widthIncreases, vector<float> lengthIncreases, vector<Branch> newBranches){
+    //Checks that the growth matches the branches in the tree
+    if(widthIncreases.size() != branchList.size() || lengthIncreases.size() != branchList.size()){
+        cout << "Error in Tree.regrowBranches(), size of growth arrays does not match the number of branches in the tree" << endl;
+        return;
+    }
+
+    //Grows each branch by the recorded amount
+    for(int i = 0; i < branchList.size(); i++){
+        Branch& branch = branchList.modify(i);
+        branch.modifySize(widthIncreases[i], lengthIncreases[i]);
+        branch.incrementAge();
+    }
+
+    //Adds the new branches back onto their parents
+    for(int i = 0; i < newBranches.size(); i++){
+        appendBranch(newBranches[i]);
+        branchList.modify(findBranch(newBranches[i].getParentIndex())).addChild(newBranches[i].getIndex());
+
+        //Makes sure that branches grown later do not reuse the index
+        maxIndex = max(maxIndex, newBranches[i].getIndex()+1);
+    }
+
+    branchesResized();
+
+    //Updates the max water and nutrients of the tree
+    updateMaxConstraints();
+}
+
 void Tree::modifyBranches(vector<float> widthIncreases, vector<float> lengthIncreases){
     //Checks that the modification is valid
     if(widthIncreases.size() != branchList.size() || lengthIncreases.size() != branchList.size()){
@@ -235,28 +450,111 @@ void Tree::modifyBranches(vector<float> widthIncreases, vector<float> lengthIncr
 
     //Loops through each of the branches in the tree
     for(int i = 0; i < branchList.size(); i++){
+        Branch& branch = branchList.modify(i);
         //Adjusts branch size
-        branchList[i]->modifySize(-widthIncreases[i], -lengthIncreases[i]);
+        branch.modifySize(-widthIncreases[i], -lengthIncreases[i]);
         //Decreases age of branch
-        branchList[i]->decrementAge();
+        branch.decrementAge();
     }
 
-    //Adjusts positions of branches in accordance with their new sizes
-    updateBranchPos();
+    //Adjusts positions of branches in accordance with their new sizes once they are needed
+    branchesResized();
 
 
     //Updates the max water and nutrients of the tree
     updateMaxConstraints();
 }
 
-int Tree::findBranch(int index){
-    //Loops through the list of branches
+int Tree::findBranch(int index) const {
+    //Looks up the position instead of searching the whole list
+    if(index < 0 || index >= branchPositions.size()){
+        return -1;
+    }
+
+    return branchPositions[index];
+}
+
+bool Tree::hasValidLinks() const {
     for(int i = 0; i < branchList.size(); i++){
-        if(branchList[i]->getIndex() == index) return i;
+        const Branch& branch = branchList[i];
+        if(branch.getParentIndex() != -1 && findBranch(branch.getParentIndex()) == -1){
+            return false;
+        }
+
+        vector<int> childIndices = branch.getChildren();
+        for(int j = 0; j < childIndices.size(); j++){
+            if(findBranch(childIndices[j]) == -1){
+                return false;
+            }
+        }
     }
 
-   // cout << "Error in Tree.findBranch(), branch with that index not found" << endl;
-    return -1;
+    //Follows the parents of every branch up to a root, which never ends if the parents form a loop.
+    //Branches that are known to reach a root are not followed again, so this takes linear time.
+    vector<bool> reachesRoot(branchList.size(), false);
+    for(int i = 0; i < branchList.size(); i++){
+        vector<int> path;
+        int position = i;
+        while(!reachesRoot[position] && !isRootBranch(position)){
+            if(path.size() == branchList.size()){
+                return false;
+            }
+            path.push_back(position);
+            position = findBranch(branchList[position].getParentIndex());
+        }
+
+        for(int j = 0; j < path.size(); j++){
+            reachesRoot[path[j]] = true;
+        }
+    }
+    return true;
+}
+
+bool Tree::isRootBranch(int position) const {
+    int parentPosition = findBranch(branchList[position].getParentIndex());
+    return parentPosition == -1 || parentPosition == position;
+}
+
+void Tree::appendBranch(const Branch& newBranch){
+    branchList.push_back(newBranch);
+    branchHash += newBranch.getHash();
+    setBranchPosition(newBranch.getIndex(), branchList.size()-1);
+}
+
+void Tree::removeBranchAt(int position){
+    int removedIndex = branchList[position].getIndex();
+    int lastPosition = branchList.size()-1;
+    branchHash -= branchList[position].getHash();
+
+    //Fills the gap with the last branch, which avoids shifting every branch after it
+    if(position != lastPosition){
+        //The last branch is only moved, so the hash of the branches does not change
+        Branch lastBranch = branchList[lastPosition];
+        branchList.modify(position) = lastBranch;
+        setBranchPosition(lastBranch.getIndex(), position);
+    }
+
+    branchList.pop_back();
+    setBranchPosition(removedIndex, -1);
+}
+
+void Tree::setBranchPosition(int index, int position){
+    //Extends the list of positions for new indices
+    while(branchPositions.size() <= index){
+        branchPositions.push_back(-1);
+    }
+
+    branchPositions.modify(index) = position;
+}
+
+const Branch* Tree::getBranch(int index){
+    int position = findBranch(index);
+
+    if(position == -1){
+        return nullptr;
+    }
+
+    return &branchList[position];
 }
 
 void Tree::updateMaxConstraints(){
@@ -264,57 +562,319 @@ void Tree::updateMaxConstraints(){
     float previousMaxNutrients = 0;
 
 
+    float totalArea = getTotalArea();
+
+    //Updates the maximum water and nutrients that can be stored in the tree
+    maxWater = totalArea/growthConfig.areaPerSupply;
+    maxNutrients = totalArea/growthConfig.areaPerSupply;
+
+}
+
+int Tree::getNumBranches() const {
+    return branchList.size();
+}
+
+int Tree::getBranchIndexAt(int position) const {
+    return branchList[position].getIndex();
+}
+
+float Tree::getTotalArea() const {
     float totalArea = 0;
 
     for(int i =0; i < branchList.size(); i++){
-        totalArea += branchList[i]->getSize();
+        totalArea += branchList[i].getSize();
     }
 
-    //Updates the maximum water and nutrients that can be stored in the tree
-    maxWater = totalArea/50;
-    maxNutrients = totalArea/50;
-
+    return totalArea;
 }
 
 void Tree::updateBranchPos(){
+    allBranchesMoved = true;
+    resolvePositions();
+}
 
-    
-    //Adjusts positions of branches in accordance with their new sizes
-    for(int i = 0; i < branchList.size(); i++){
-        //Moves child branches to account for the change in size of their parent
+void Tree::resolvePositions() const {
+    if(allBranchesMoved){
+        //Branches can be stored in any order, so the tree is followed outwards from each branch with no parent,
+        //which moves every parent before its children
+        vector<int> branchesToMove;
+        for(int i = 0; i < branchList.size(); i++){
+            if(isRootBranch(i)){
+                branchesToMove.push_back(i);
+            }
+        }
+        moveChildren(branchesToMove);
+    }else{
+        //Only the subtrees below the recorded branches are moved. Branches that have been removed since are skipped.
+        vector<int> branchesToMove;
+        for(int i = 0; i < movedBranches.size(); i++){
+            int position = findBranch(movedBranches[i]);
+            if(position != -1){
+                branchesToMove.push_back(position);
+            }
+        }
+        moveChildren(branchesToMove);
+    }
+
+    allBranchesMoved = false;
+    movedBranches.clear();
+}
+
+void Tree::branchesResized(){
+    //Positions are not part of the hash, so it can be worked out before the branches move
+    rehashBranches();
+    allBranchesMoved = true;
+    movedBranches.clear();
+
+    //The supply of each branch depends on its width
+    allBranchesResupplied = true;
+    resuppliedBranches.clear();
+}
+
+void Tree::moveChildren(vector<int> branchesToMove) const {
+    while(!branchesToMove.empty()){
+        int position = branchesToMove.back();
+        branchesToMove.pop_back();
 
         //Gets children of current branch
-        vector<int> childIndices = branchList[i]->getChildren();
+        vector<int> childIndices = branchList[position].getChildren();
 
         //Gets new position of the tip of the current branch
         float newTipX;
         float newTipY;
-        branchList[i]->getTipPos(newTipX, newTipY);
+        branchList[position].getTipPos(newTipX, newTipY);
 
-        //Loops through all of the children
+        //Moves child branches to account for the change in size of their parent
         for(int i = 0; i < childIndices.size(); i++){
-            //Adjusts position of branches
-            branchList[findBranch(childIndices[i])]->setPos(newTipX, newTipY);
+            int childPosition = findBranch(childIndices[i]);
+            if(childPosition == -1 || childPosition == position){
+                continue;
+            }
+
+            branchList.modify(childPosition).setPos(newTipX, newTipY);
+            branchesToMove.push_back(childPosition);
         }
     }
 }
 
-void Tree::draw(Mat* img){
+void Tree::rehashBranches(){
+    branchHash = 0;
     for(int i = 0; i < branchList.size(); i++){
-        branchList[i]->draw(img);
+        branchHash += branchList[i].getHash();
     }
 }
 
-int Tree::getClickedIndex(int mouseX, int mouseY) {
+void Tree::draw(Mat* img) const {
+    resolvePositions();
     for(int i = 0; i < branchList.size(); i++){
-        if(branchList[i]->containsMouse(mouseX, mouseY)){
-            return branchList[i]->getIndex();
+        branchList[i].draw(img);
+    }
+}
+
+int Tree::getClickedIndex(int mouseX, int mouseY) const {
+    resolvePositions();
+    for(int i = 0; i < branchList.size(); i++){
+        if(branchList[i].containsMouse(mouseX, mouseY)){
+            return branchList[i].getIndex();
         }
     }
     return -1;
 }
 
+unsigned int Tree::getRandomState(){
+    return randomState;
+}
+
+const GrowthConfig& Tree::getGrowthConfig() const {
+    return growthConfig;
+}
+
+void Tree::setGrowthConfig(const GrowthConfig& newConfig){
+    growthConfig = newConfig;
+
+    //The amount of water and nutrients the tree can store depends on the config
+    updateMaxConstraints();
+}
+
+int Tree::getDepth() const {
+    //Follows the tree outwards from each branch with no parent, as resolvePositions() does, with the depth of each branch
+    vector<pair<int, int>> branchesToVisit;
+    for(int i = 0; i < branchList.size(); i++){
+        if(isRootBranch(i)){
+            branchesToVisit.push_back(make_pair(i, 1));
+        }
+    }
+
+    int maxDepth = 0;
+    while(!branchesToVisit.empty()){
+        int position = branchesToVisit.back().first;
+        int depth = branchesToVisit.back().second;
+        branchesToVisit.pop_back();
+        maxDepth = max(maxDepth, depth);
+
+        vector<int> childIndices = branchList[position].getChildren();
+        for(int i = 0; i < childIndices.size(); i++){
+            int childPosition = findBranch(childIndices[i]);
+            if(childPosition != -1 && childPosition != position){
+                branchesToVisit.push_back(make_pair(childPosition, depth+1));
+            }
+        }
+    }
+
+    return maxDepth;
+}
+
+bool Tree::overlapsBranches(const Branch& newBranch, int parentPosition, const SpatialHash& branchGrid) const {
+    Point2f minCorner, maxCorner;
+    newBranch.getBounds(minCorner, maxCorner);
+    int parentIndex = branchList[parentPosition].getIndex();
+
+    //Stops at the first overlap, so a new branch in a crowded part of the tree is given up on quickly
+    return branchGrid.findAny(minCorner.x, minCorner.y, maxCorner.x, maxCorner.y, [&](int position){
+        const Branch& branch = branchList[position];
+        if(position == parentPosition || branch.getParentIndex() == parentIndex){
+            return false;
+        }
+        return newBranch.overlaps(branch);
+    });
+}
+
+float Tree::getSupplyShare(int index) const {
+    if(findBranch(index) == -1){
+        return 0;
+    }
+
+    resolveSupply();
+    return branchSupplies[index].share;
+}
+
+void Tree::resolveSupply() const {
+    //Makes room for the supply of every index
+    while(branchSupplies.size() < branchPositions.size()){
+        branchSupplies.push_back(BranchSupply());
+    }
+
+    if(allBranchesResupplied){
+        //The supply is shared between the branches with no parent in proportion to their widths
+        vector<pair<int, float>> branchesToShare;
+        float totalWidth = 0;
+        for(int i = 0; i < branchList.size(); i++){
+            if(isRootBranch(i)){
+                totalWidth += branchList[i].getRect().size.width;
+                branchesToShare.push_back(make_pair(i, 0.0f));
+            }
+        }
+        for(int i = 0; i < branchesToShare.size(); i++){
+            branchesToShare[i].second = branchList[branchesToShare[i].first].getRect().size.width/totalWidth;
+        }
+        shareSupply(branchesToShare);
+    }else{
+        //Only the way the supply is shared below the recorded branches has changed. Each one is shared out before
+        //the inflow of the next is read, as one recorded branch can be below another and have its inflow changed.
+        for(int i = 0; i < resuppliedBranches.size(); i++){
+            int position = findBranch(resuppliedBranches[i]);
+            if(position != -1){
+                shareSupply({make_pair(position, branchSupplies[resuppliedBranches[i]].inflow)});
+            }
+        }
+    }
+
+    allBranchesResupplied = false;
+    resuppliedBranches.clear();
+}
+
+void Tree::shareSupply(vector<pair<int, float>> branchesToShare) const {
+    vector<int> childPositions;
+    while(!branchesToShare.empty()){
+        int position = branchesToShare.back().first;
+        float inflow = branchesToShare.back().second;
+        branchesToShare.pop_back();
+        const Branch& branch = branchList[position];
+
+        //The branch and its children split the inflow in proportion to their widths
+        float totalWidth = branch.getRect().size.width;
+        childPositions.clear();
+        vector<int> childIndices = branch.getChildren();
+        for(int i = 0; i < childIndices.size(); i++){
+            int childPosition = findBranch(childIndices[i]);
+            if(childPosition != -1 && childPosition != position){
+                childPositions.push_back(childPosition);
+                totalWidth += branchList[childPosition].getRect().size.width;
+            }
+        }
+
+        //Branches that have withered away keep whatever reaches them
+        BranchSupply& supply = branchSupplies.modify(branch.getIndex());
+        supply.inflow = inflow;
+        if(!(totalWidth > 0)){
+            supply.share = inflow;
+            continue;
+        }
+
+        supply.share = inflow*branch.getRect().size.width/totalWidth;
+        for(int i = 0; i < childPositions.size(); i++){
+            float childInflow = inflow*branchList[childPositions[i]].getRect().size.width/totalWidth;
+            branchesToShare.push_back(make_pair(childPositions[i], childInflow));
+        }
+    }
+}
+
+void Tree::supplyChanged(int position){
+    if(allBranchesResupplied){
+        return;
+    }
+
+    //Only the subtree of the parent is shared out differently
+    if(isRootBranch(position)){
+        allBranchesResupplied = true;
+        resuppliedBranches.clear();
+    }else{
+        resuppliedBranches.push_back(branchList[position].getParentIndex());
+    }
+}
+
+void Tree::setRandomState(unsigned int newRandomState){
+    randomState = newRandomState;
+}
+
+unsigned int Tree::getChecksum() const {
+    resolvePositions();
+    unsigned int checksum = CHECKSUM_START;
+    checksum = addToChecksum(checksum, waterLevel);
+    checksum = addToChecksum(checksum, nutrientLevel);
+    checksum = addToChecksum(checksum, maxIndex);
+    checksum = addToChecksum(checksum, randomState);
+
+    //Branches are added in the order they are stored, so trees with the same branches in a different order differ
+    for(int i = 0; i < branchList.size(); i++){
+        checksum = branchList[i].addToChecksum(checksum);
+    }
+
+    return checksum;
+}
+
+unsigned int Tree::getStateHash() const {
+    unsigned int hash = addToHash(branchHash, (int)branchList.size());
+    hash = addToHash(hash, waterLevel);
+    hash = addToHash(hash, nutrientLevel);
+    hash = addToHash(hash, maxIndex);
+    hash = addToHash(hash, randomState);
+
+    return finishHash(hash);
+}
+
+float Tree::randomFraction(){
+    //Uses a xorshift generator rather than rand(), so each tree has its own sequence that is the same on every platform
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+
+    //Uses the top 24 bits, which a float can store exactly
+    return (randomState >> 8) / 16777216.0f;
+}
+
 void Tree::printData(){
+    resolvePositions();
     cout << "Tree object" << endl;
     cout << "Water level: " << waterLevel;
     cout << "Fertiliser level: " << nutrientLevel;
@@ -327,7 +887,9 @@ void Tree::printData(){
     //Loops through each of the branches in the tree
     cout << "List of branches in the tree: " << endl;
     for(int i = 0; i < branchList.size(); i++){
-        branchList[i]->printData();
+        //Prints a copy, as the branches in the list can only be read
+        Branch branch = branchList[i];
+        branch.printData();
     }
         
     cout << "Water level: " << waterLevel << endl;;
@@ -339,22 +901,435 @@ void Tree::printData(){
 
 // Serialization to JSON
 nlohmann::json Tree::toJson() const {
+    resolvePositions();
     nlohmann::json j;
     j["waterLevel"] = this->waterLevel;
     j["maxWater"] = this->maxWater;
     j["nutrientLevel"] = this->nutrientLevel;
     j["maxNutrients"] = this->maxNutrients;
     j["maxIndex"] = this->maxIndex;
+    j["randomState"] = this->randomState;
 
     j["branchList"] = nlohmann::json::array();
-    for (const Branch* branch_ptr : this->branchList) {
-        if (branch_ptr) { // Ensure pointer is not null
-            j["branchList"].push_back(branch_ptr->toJson());
-        }
+    for (int i = 0; i < this->branchList.size(); i++) {
+        j["branchList"].push_back(this->branchList[i].toJson());
     }
     return j;
 }
 
+void Tree::writeJson(JsonWriter& writer) const {
+    resolvePositions();
+    writer.beginObject();
+    writer.field("waterLevel", waterLevel);
+    writer.field("maxWater", maxWater);
+    writer.field("nutrientLevel", nutrientLevel);
+    writer.field("maxNutrients", maxNutrients);
+    writer.field("maxIndex", maxIndex);
+    writer.field("randomState", randomState);
+
+    writer.key("growthConfig");
+    writer.beginObject();
+    for (const auto& parameter : SAVED_GROWTH_PARAMETERS) {
+        writer.field(parameter.first, growthConfig.*parameter.second);
+    }
+    writer.field("growthLaw", (int)growthConfig.growthLaw);
+    writer.field("supplyModel", (int)growthConfig.supplyModel);
+    writer.endObject();
+
+    writer.key("branchList");
+    writer.beginArray();
+    for (int i = 0; i < branchList.size(); i++) {
+        branchList[i].writeJson(writer);
+    }
+    writer.endArray();
+    writer.endObject();
+}
+
+void Tree::writeSave(ostream& stream) const {
+    resolvePositions();
+    int numBranches = branchList.size();
+
+    //Gathers each field of the branches into its own array
+    vector<int> indices, parentIndices, ages, childOffsets, children;
+    vector<float> centreXs, centreYs, widths, lengths, angles;
+    for(int i = 0; i < numBranches; i++){
+        const Branch& branch = branchList[i];
+        const RotatedRect& rect = branch.getRect();
+        indices.push_back(branch.getIndex());
+        parentIndices.push_back(branch.getParentIndex());
+        centreXs.push_back(rect.center.x);
+        centreYs.push_back(rect.center.y);
+        widths.push_back(rect.size.width);
+        lengths.push_back(rect.size.height);
+        angles.push_back(rect.angle);
+        ages.push_back(branch.getAge());
+
+        childOffsets.push_back(children.size());
+        vector<int> branchChildren = branch.getChildren();
+        children.insert(children.end(), branchChildren.begin(), branchChildren.end());
+    }
+    childOffsets.push_back(children.size());
+
+    TreeSaveHeader header;
+    header.numBranches = numBranches;
+    header.numChildLinks = children.size();
+    header.waterLevel = waterLevel;
+    header.maxWater = maxWater;
+    header.nutrientLevel = nutrientLevel;
+    header.maxNutrients = maxNutrients;
+    header.maxIndex = maxIndex;
+    header.randomState = randomState;
+
+    writeValue(stream, header);
+    writeArray(stream, indices);
+    writeArray(stream, parentIndices);
+    writeArray(stream, centreXs);
+    writeArray(stream, centreYs);
+    writeArray(stream, widths);
+    writeArray(stream, lengths);
+    writeArray(stream, angles);
+    writeArray(stream, ages);
+    writeArray(stream, childOffsets);
+    writeArray(stream, children);
+    writeGrowthConfig(stream, growthConfig);
+}
+
+Tree* Tree::fromSave(const char* data, size_t size, bool hasGrowthConfig) {
+    if(size < sizeof(TreeSaveHeader)){
+        cout << "Error in Tree.fromSave(), the data is too small to hold a tree" << endl;
+        return nullptr;
+    }
+
+    TreeSaveHeader header;
+    memcpy(&header, data, sizeof(header));
+
+    //Checks that every array fits in the data before any of them are read
+    size_t numBranches = header.numBranches;
+    size_t requiredSize = sizeof(header) + (8*numBranches + numBranches+1 + header.numChildLinks)*4;
+    if(hasGrowthConfig){
+        requiredSize += SAVED_GROWTH_CONFIG_SIZE;
+    }
+    if(numBranches == 0 || size < requiredSize){
+        cout << "Error in Tree.fromSave(), the data does not hold " << numBranches << " branches" << endl;
+        return nullptr;
+    }
+
+    //The arrays are used where they are, without copying them first
+    const int* indices = reinterpret_cast<const int*>(data + sizeof(header));
+    const int* parentIndices = indices + numBranches;
+    const float* centreXs = reinterpret_cast<const float*>(parentIndices + numBranches);
+    const float* centreYs = centreXs + numBranches;
+    const float* widths = centreYs + numBranches;
+    const float* lengths = widths + numBranches;
+    const float* angles = lengths + numBranches;
+    const int* ages = reinterpret_cast<const int*>(angles + numBranches);
+    const int* childOffsets = ages + numBranches;
+    const int* children = childOffsets + numBranches + 1;
+
+    if(header.maxIndex > MAX_LOADED_BRANCH_INDEX){
+        cout << "Error in Tree.fromSave(), the maximum branch index " << header.maxIndex << " is too large" << endl;
+        return nullptr;
+    }
+    if(childOffsets[0] != 0 || childOffsets[numBranches] != header.numChildLinks){
+        cout << "Error in Tree.fromSave(), the child links are invalid" << endl;
+        return nullptr;
+    }
+    for(int i = 0; i < numBranches; i++){
+        if(childOffsets[i] > childOffsets[i+1]){
+            cout << "Error in Tree.fromSave(), the child links are invalid" << endl;
+            return nullptr;
+        }
+        if(indices[i] < 0 || indices[i] >= header.maxIndex){
+            cout << "Error in Tree.fromSave(), branch index " << indices[i] << " is invalid" << endl;
+            return nullptr;
+        }
+    }
+
+    //The config is after the arrays, and saves made before it was saved were grown with the default config
+    GrowthConfig config;
+    const char* configData = reinterpret_cast<const char*>(children + header.numChildLinks);
+    if(hasGrowthConfig && !readGrowthConfig(configData, data + size, config)){
+        cout << "Error in Tree.fromSave(), the growth config is invalid" << endl;
+        return nullptr;
+    }
+
+    Tree* newTree = nullptr;
+    for(int i = 0; i < numBranches; i++){
+        Branch branch(indices[i], parentIndices[i], vector<int>(children + childOffsets[i], children + childOffsets[i+1]),
+            RotatedRect(Point2f(centreXs[i], centreYs[i]), Size2f(widths[i], lengths[i]), angles[i]), ages[i]);
+
+        //The first branch is given to the constructor, and the rest are added after it in the same order
+        if(newTree == nullptr){
+            newTree = new Tree(header.waterLevel, header.nutrientLevel, new Branch(branch), header.randomState);
+        }else if(newTree->findBranch(indices[i]) != -1){
+            cout << "Error in Tree.fromSave(), branch index " << indices[i] << " is used more than once" << endl;
+            delete newTree;
+            return nullptr;
+        }else{
+            newTree->appendBranch(branch);
+        }
+    }
+
+    if(!newTree->hasValidLinks()){
+        cout << "Error in Tree.fromSave(), a branch is linked to a branch that is not in the tree, or its parents form a loop" << endl;
+        delete newTree;
+        return nullptr;
+    }
+
+    newTree->maxWater = header.maxWater;
+    newTree->maxNutrients = header.maxNutrients;
+    newTree->maxIndex = header.maxIndex;
+    newTree->growthConfig = config;
+
+    return newTree;
+}
+
+void Tree::writePackedSave(ostream& stream, bool quantizeGeometry) const {
+    resolvePositions();
+    writeVarint(stream, branchList.size());
+    writeValue(stream, waterLevel);
+    writeValue(stream, maxWater);
+    writeValue(stream, nutrientLevel);
+    writeValue(stream, maxNutrients);
+    writeVarint(stream, maxIndex);
+    writeValue(stream, randomState);
+    writeGrowthConfig(stream, growthConfig);
+
+    int previousIndex = 0;
+    for(int i = 0; i < branchList.size(); i++){
+        const Branch& branch = branchList[i];
+        const RotatedRect& rect = branch.getRect();
+        int index = branch.getIndex();
+
+        //Branches are mostly stored in index order and close to their parents, so the differences are small
+        writeSignedVarint(stream, index - previousIndex);
+        writeSignedVarint(stream, index - branch.getParentIndex());
+        previousIndex = index;
+
+        //Rounded positions are only stored for branches without a parent, as the rest are moved to their parent's tip
+        bool storesPosition = !quantizeGeometry || isRootBranch(i);
+        writeVarint(stream, branch.getAge()*2 + storesPosition);
+
+        vector<int> children = branch.getChildren();
+        writeVarint(stream, children.size());
+        int previousChild = index;
+        for(int j = 0; j < children.size(); j++){
+            writeSignedVarint(stream, children[j] - previousChild);
+            previousChild = children[j];
+        }
+
+        if(quantizeGeometry){
+            writeSignedVarint(stream, lround(rect.size.width*PACKED_SIZE_SCALE));
+            writeSignedVarint(stream, lround(rect.size.height*PACKED_SIZE_SCALE));
+            writeSignedVarint(stream, lround(rect.angle*PACKED_ANGLE_SCALE));
+        }else{
+            writeValue(stream, rect.size.width);
+            writeValue(stream, rect.size.height);
+            writeValue(stream, rect.angle);
+        }
+        if(storesPosition){
+            writeValue(stream, rect.center.x);
+            writeValue(stream, rect.center.y);
+        }
+    }
+}
+
+Tree* Tree::fromPackedSave(const char* data, size_t size, bool quantizedGeometry, bool hasGrowthConfig) {
+    const char* position = data;
+    const char* end = data + size;
+
+    TreeSaveHeader header;
+    unsigned int maxIndex;
+    bool valid = readVarint(position, end, header.numBranches) && readValue(position, end, header.waterLevel) &&
+        readValue(position, end, header.maxWater) && readValue(position, end, header.nutrientLevel) &&
+        readValue(position, end, header.maxNutrients) && readVarint(position, end, maxIndex) &&
+        readValue(position, end, header.randomState);
+    //Saves made before the config was saved were grown with the default config
+    GrowthConfig config;
+    if(valid && hasGrowthConfig && !readGrowthConfig(position, end, config)){
+        cout << "Error in Tree.fromPackedSave(), the growth config is invalid" << endl;
+        return nullptr;
+    }
+    //Every branch takes at least four bytes, which stops a damaged count from reserving too much memory
+    if(!valid || header.numBranches == 0 || header.numBranches > size/4){
+        cout << "Error in Tree.fromPackedSave(), the data does not hold a tree" << endl;
+        return nullptr;
+    }
+    if(maxIndex > MAX_LOADED_BRANCH_INDEX){
+        cout << "Error in Tree.fromPackedSave(), the maximum branch index " << maxIndex << " is too large" << endl;
+        return nullptr;
+    }
+    header.maxIndex = maxIndex;
+
+    vector<Branch> branches;
+    branches.reserve(header.numBranches);
+    bool hasMovedBranches = false;
+    int previousIndex = 0;
+    for(int i = 0; i < header.numBranches; i++){
+        int indexDifference = 0, parentDifference = 0;
+        unsigned int ageAndPosition = 0, numChildren = 0;
+        valid = readSignedVarint(position, end, indexDifference) && readSignedVarint(position, end, parentDifference) &&
+            readVarint(position, end, ageAndPosition) && readVarint(position, end, numChildren) && numChildren <= end - position;
+
+        int index = previousIndex + indexDifference;
+        previousIndex = index;
+
+        vector<int> children;
+        int previousChild = index;
+        for(int j = 0; valid && j < numChildren; j++){
+            int childDifference = 0;
+            valid = readSignedVarint(position, end, childDifference);
+            previousChild += childDifference;
+            children.push_back(previousChild);
+        }
+
+        RotatedRect rect;
+        if(quantizedGeometry){
+            int width = 0, length = 0, angle = 0;
+            valid = valid && readSignedVarint(position, end, width) && readSignedVarint(position, end, length) &&
+                readSignedVarint(position, end, angle);
+            rect.size = Size2f(width/PACKED_SIZE_SCALE, length/PACKED_SIZE_SCALE);
+            rect.angle = angle/PACKED_ANGLE_SCALE;
+        }else{
+            valid = valid && readValue(position, end, rect.size.width) && readValue(position, end, rect.size.height) &&
+                readValue(position, end, rect.angle);
+        }
+        if(ageAndPosition & 1){
+            valid = valid && readValue(position, end, rect.center.x) && readValue(position, end, rect.center.y);
+        }else{
+            hasMovedBranches = true;
+        }
+
+        if(!valid){
+            cout << "Error in Tree.fromPackedSave(), the data ends in the middle of branch " << i << endl;
+            return nullptr;
+        }
+        if(index < 0 || index >= header.maxIndex){
+            cout << "Error in Tree.fromPackedSave(), branch index " << index << " is invalid" << endl;
+            return nullptr;
+        }
+
+        branches.push_back(Branch(index, index - parentDifference, children, rect, ageAndPosition/2));
+    }
+
+    Tree* newTree = new Tree(header.waterLevel, header.nutrientLevel, new Branch(branches[0]), header.randomState);
+    for(int i = 1; i < branches.size(); i++){
+        if(newTree->findBranch(branches[i].getIndex()) != -1){
+            cout << "Error in Tree.fromPackedSave(), branch index " << branches[i].getIndex() << " is used more than once" << endl;
+            delete newTree;
+            return nullptr;
+        }
+        newTree->appendBranch(branches[i]);
+    }
+
+    if(!newTree->hasValidLinks()){
+        cout << "Error in Tree.fromPackedSave(), a branch is linked to a branch that is not in the tree, or its parents form a loop" << endl;
+        delete newTree;
+        return nullptr;
+    }
+
+    newTree->maxWater = header.maxWater;
+    newTree->maxNutrients = header.maxNutrients;
+    newTree->maxIndex = header.maxIndex;
+    newTree->growthConfig = config;
+
+    //Puts branches whose positions were not stored at the tips of their parents once they are needed
+    if(hasMovedBranches){
+        newTree->allBranchesMoved = true;
+    }
+
+    return newTree;
+}
+
+Tree* Tree::readJson(JsonReader& reader) {
+    //The tree is created when its first branch is read, so it is freed if a later part of the JSON is invalid
+    unique_ptr<Tree> newTree;
+
+    //Keys can be in any order, so the other fields are only set once the whole tree has been read
+    float water = 0;
+    float maxWater = 0;
+    float nutrients = 0;
+    float maxNutrients = 0;
+    int maxIndex = 0;
+    unsigned int randomState = 0;
+    bool hasRandomState = false;
+    int largestIndex = 0;
+    //Saves made before the config was saved were grown with the default config
+    GrowthConfig config;
+
+    string key;
+    reader.beginObject();
+    while (reader.nextKey(key)) {
+        if (key == "waterLevel") {
+            water = reader.readFloat();
+        } else if (key == "maxWater") {
+            maxWater = reader.readFloat();
+        } else if (key == "nutrientLevel") {
+            nutrients = reader.readFloat();
+        } else if (key == "maxNutrients") {
+            maxNutrients = reader.readFloat();
+        } else if (key == "maxIndex") {
+            maxIndex = reader.readInt();
+            if (maxIndex > MAX_LOADED_BRANCH_INDEX) {
+                reader.fail("the maximum branch index " + to_string(maxIndex) + " is too large");
+            }
+        } else if (key == "randomState") {
+            randomState = reader.readUnsigned();
+            hasRandomState = true;
+        } else if (key == "growthConfig") {
+            config = readGrowthConfig(reader);
+        } else if (key == "branchList") {
+            reader.beginArray();
+            while (reader.nextElement()) {
+                Branch branch = Branch::readJson(reader);
+                //Branches are added before the maximum index might be read, so their indices are limited straight away
+                if (branch.getIndex() < 0 || branch.getIndex() >= MAX_LOADED_BRANCH_INDEX) {
+                    reader.fail("branch index " + to_string(branch.getIndex()) + " is invalid");
+                }
+
+                largestIndex = max(largestIndex, branch.getIndex());
+
+                if (newTree == nullptr) {
+                    newTree.reset(new Tree(water, nutrients, new Branch(branch)));
+                } else if (newTree->findBranch(branch.getIndex()) != -1) {
+                    reader.fail("branch index " + to_string(branch.getIndex()) + " is used more than once");
+                } else {
+                    newTree->appendBranch(branch);
+                }
+            }
+        } else {
+            reader.skipValue();
+        }
+    }
+
+    if (newTree == nullptr) {
+        reader.fail("the tree has no branches");
+    }
+    //New branches are given the maximum index, so it must be after every index that is already used
+    if (largestIndex >= maxIndex) {
+        reader.fail("branch index " + to_string(largestIndex) + " is not below the maximum index " + to_string(maxIndex));
+    }
+    if (!newTree->hasValidLinks()) {
+        reader.fail("a branch is linked to a branch that is not in the tree, or its parents form a loop");
+    }
+
+    newTree->waterLevel = water;
+    newTree->maxWater = maxWater;
+    newTree->nutrientLevel = nutrients;
+    newTree->maxNutrients = maxNutrients;
+    newTree->maxIndex = maxIndex;
+    newTree->growthConfig = config;
+    // Saves made before trees were seeded have no random state, so they keep the time-based seed
+    if (hasRandomState) {
+        newTree->randomState = randomState;
+    }
+
+    //Recalculates the maximum water and nutrients in the same way as fromJson()
+    newTree->updateMaxConstraints();
+
+    return newTree.release();
+}
+
 // Deserialization from JSON
 // The windowWidth and windowHeight parameters are not strictly needed here if branch positions are absolute.
 // However, the original Tree constructor takes a trunk, which is positioned using window dimensions.
@@ -384,13 +1359,12 @@ Tree* Tree::fromJson(const nlohmann::json& j) {
     // Let's assume the first branch in the JSON's branchList can serve as the trunk for constructor,
     // or that branchList is ordered such that the trunk is first.
 
-    std::vector<Branch*> tempBranchList;
+    std::vector<Branch> tempBranchList;
     const nlohmann::json& branches_json = j.at("branchList");
     if (branches_json.is_array()) {
         for (const auto& branch_j : branches_json) {
-            // Branch::fromJson returns a Branch object (by value). We need Branch* for branchList.
-            Branch b_val = Branch::fromJson(branch_j);
-            tempBranchList.push_back(new Branch(b_val)); // Create a new Branch on the heap
+            // Branch::fromJson returns a Branch object (by value), which is what branchList stores.
+            tempBranchList.push_back(Branch::fromJson(branch_j));
         }
     }
 
@@ -405,9 +1379,9 @@ Tree* Tree::fromJson(const nlohmann::json& j) {
 
     // Assuming the first branch in the list is the trunk.
     // This is an assumption that needs to be ensured during serialization or handled more robustly.
-    Branch* trunk = tempBranchList[0]; 
+    Branch* trunk = new Branch(tempBranchList[0]);
 
-    Tree* newTree = new Tree(water, nutrients, trunk); // Trunk is now owned by newTree
+    Tree* newTree = new Tree(water, nutrients, trunk); // Trunk is copied into newTree and freed
 
     // Remove the trunk from tempBranchList as it's already added via constructor
     // and Tree's constructor adds it to its own branchList.
@@ -415,14 +1389,13 @@ Tree* Tree::fromJson(const nlohmann::json& j) {
     
     // Clear the default branchList created by the Tree constructor (which just contains the trunk)
     // and rebuild it from our deserialized list.
-    for(Branch* b : newTree->branchList) { // Delete the initial trunk added by constructor if it's not the one from JSON
-        if (b != trunk) delete b; // Avoid double delete if trunk was the same
-    }
     newTree->branchList.clear(); 
+    newTree->branchPositions.clear();
+    newTree->branchHash = 0;
 
     // Add all deserialized branches (including the one we designated as trunk)
-    for (Branch* b_ptr : tempBranchList) {
-        newTree->branchList.push_back(b_ptr);
+    for (const Branch& b : tempBranchList) {
+        newTree->appendBranch(b);
     }
     
     // Restore other Tree properties
@@ -430,6 +1403,10 @@ Tree* Tree::fromJson(const nlohmann::json& j) {
     newTree->nutrientLevel = j.at("nutrientLevel").get<float>(); // Already set by constructor, but overwrite if different
     newTree->maxNutrients = j.at("maxNutrients").get<float>();
     newTree->maxIndex = j.at("maxIndex").get<int>();
+    // Saves made before trees were seeded have no random state, so they keep the time-based seed
+    if (j.contains("randomState")) {
+        newTree->randomState = j.at("randomState").get<unsigned int>();
+    }
     
     // Important: updateMaxConstraints might be needed if it's not implicitly handled by restoring values.
     // The original updateMaxConstraints calculates based on totalArea of branches.
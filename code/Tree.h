@@ -2,10 +2,15 @@
 #define TREE_H
 
 #include <vector>
+#include <algorithm>
 #include <opencv2/core.hpp>
 #include <iostream>
+#include <ctime>
 #include "Branch.h"
 #include "Printable.h"
+#include "PersistentVector.h"
+#include "GrowthConfig.h"
+#include "SpatialHash.h"
 #include "include/nlohmann/json.hpp" // For JSON serialization
 
 // Forward declaration for nlohmann::json
@@ -15,10 +20,41 @@ namespace nlohmann {
 
 using namespace std;
 
+//Largest maximum branch index that a loaded tree may have. The position of each branch is stored at its index,
+//so this limits the memory that a damaged save can make the tree use.
+const int MAX_LOADED_BRANCH_INDEX = 1 << 24;
+
+//A subtree that has been cut off a tree, which owns copies of its branches so that it can be put back
+struct DetachedBranches {
+    //The branches in the subtree, starting with the pruned branch, with every parent before its children
+    vector<Branch> branches;
+
+    //The position in the branch list that each branch was removed from
+    vector<int> listPositions;
+
+    //The position of the pruned branch in its parent's list of children, or -1 if it had no parent
+    int positionInParent = -1;
+};
+
+//The part of the tree's water and nutrients that reaches a branch under the vascular supply model
+struct BranchSupply {
+    //Fraction of the tree's supply that flows into the branch from its parent
+    float inflow = 0;
+
+    //Fraction of the tree's supply that the branch keeps to grow with, with the rest passed on to its children
+    float share = 0;
+};
+
 class Tree : public Printable{
     public:
-        Tree(float initialWater, float initialNutrients, Branch* trunk);
-        ~Tree();
+        //Creates a tree with a copy of the given trunk, which is then freed.
+        //Trees created with the same seed grow in the same way.
+        Tree(float initialWater, float initialNutrients, Branch* trunk, unsigned int seed = time(NULL));
+
+        //Copying a tree takes constant time, as the copies share their branches until one of them changes.
+        //This lets the timeline keep many past states of the tree cheaply.
+        Tree(const Tree& otherTree) = default;
+        Tree& operator=(const Tree& otherTree) = default;
 
         //Adds water and nutrients
         float addWater(float litres);
@@ -28,35 +64,86 @@ class Tree : public Printable{
         void removeWater(float litres);
         void removeNutrients(float kilograms);
 
-        //removes a branch from the tree, along with all of its child branches
-        void pruneBranch(int branchIndex, vector<Branch*> &removedBranches);
+        //Removes a branch from the tree, along with all of its child branches, in time proportional to the
+        //number of branches removed
+        void pruneBranch(int branchIndex, DetachedBranches &removedBranches);
+
+        //Puts pruned branches back exactly where they were, undoing the last call to pruneBranch()
+        void restoreBranches(const DetachedBranches &removedBranches);
 
         //Adds branches to the list
-        void addBranches(vector<Branch*> newBranches);
+        void addBranches(vector<Branch> newBranches);
 
-        //Increases the size of branches and possibly adds new branches
+        //Increases the size of branches and possibly adds new branches, using the growth law in the tree's config
         void grow(float &waterConsumed, float &nutrientsConsumed, 
         vector<float> &widthIncreases, vector<float> &lengthIncreases, vector<int> &branchesGrown);
 
         //Removes branches from tree
         void removeBranches(vector<int> branchIndices);
 
+        //Grows the existing branches by the given amounts and adds copies of the given new branches,
+        //repeating a previous call to grow()
+        void regrowBranches(vector<float> widthIncreases, vector<float> lengthIncreases, vector<Branch> newBranches);
+
+        //Returns the branch with the given index, or nullptr if it is not in the tree. Its position can be out of
+        //date until resolvePositions() is called.
+        const Branch* getBranch(int index);
+
         //Changes the dimensions of the branhes
         void modifyBranches(vector<float> widthIncreases, vector<float> lengthIncreases);
 
 
         //Finds the position of a branch with a given index in the branch list
-        int findBranch(int index);
+        int findBranch(int index) const;
 
         //Updates the maximum water and nutrients that the tree can store
         void updateMaxConstraints();
 
-        //Updates the positions of the branches if necessary
+        //Moves every branch to the tip of its parent straight away. Any changes made directly to the branch list
+        //before it are included.
         void updateBranchPos();
 
-        void draw(Mat* img);
+        //Moves the branches whose parents have changed size since the positions were last worked out. Changes to
+        //the tree only record which subtrees have moved, and the positions are worked out here when they are
+        //needed, such as for drawing or saving, so growing many times in a row only moves each branch once.
+        //A tree must be resolved before it is copied to another thread, as resolving changes its branch list.
+        void resolvePositions() const;
 
-        int getClickedIndex(int mouseX, int mouseY);
+        void draw(Mat* img) const;
+
+        int getClickedIndex(int mouseX, int mouseY) const;
+
+        int getNumBranches() const;
+
+        //Returns the index of the branch at a position in the branch list, from 0 up to getNumBranches()
+        int getBranchIndexAt(int position) const;
+
+        //Returns the total area of every branch, which sets how much water and nutrients the tree can store
+        float getTotalArea() const;
+
+        //Gets and sets the parameters of the growth model, which only affect growth from then on
+        const GrowthConfig& getGrowthConfig() const;
+        void setGrowthConfig(const GrowthConfig& newConfig);
+
+        //Returns the number of branches on the longest path from a branch with no parent to a tip
+        int getDepth() const;
+
+        //Returns the fraction of the tree's water and nutrients that a branch grows with under the vascular supply
+        //model, or 0 if it is not in the tree. The shares are worked out in one pass over the tree after it grows,
+        //and pruning only works them out again for the parent of the pruned branch and the rest of its subtree.
+        float getSupplyShare(int index) const;
+
+        //Gets and sets the state of the random number generator used for growth
+        unsigned int getRandomState();
+        void setRandomState(unsigned int newRandomState);
+
+        //Returns a checksum of the whole state of the tree, which is equal for trees that are exactly the same
+        unsigned int getChecksum() const;
+
+        //Returns a hash of the whole state of the tree in constant time, as the hash of the branches is kept up to date
+        //as they change. It is equal for trees with exactly the same branches, in any order, and the same levels.
+        //The positions of the branches are left out, as they follow from the rest of the tree.
+        unsigned int getStateHash() const;
 
         void printData();
 
@@ -66,16 +153,117 @@ class Tree : public Printable{
         // For now, we'll assume it reconstructs a new Tree object.
         // The Game class will handle creating the initial trunk if needed for a new game vs. loading.
         static Tree* fromJson(const nlohmann::json& j);
+        //Writes the same JSON as toJson() straight to a writer, one branch at a time, which saves large
+        //trees much faster than building the JSON in memory
+        void writeJson(JsonWriter& writer) const;
+        //Reads a tree written by writeJson() or toJson(), adding each branch to the tree as soon as it is read
+        //rather than building the whole JSON in memory first. Throws a JsonReadError if the tree is not valid.
+        static Tree* readJson(JsonReader& reader);
+
+        //Writes the tree in the binary save format described in SaveFormat.h
+        void writeSave(ostream& stream) const;
+        //Creates a tree from binary save data, which is normally a memory mapped file. Data from saves that were
+        //written before the growth config was saved has no config, and the tree gets the default config.
+        //Returns nullptr if the data is not a valid tree.
+        static Tree* fromSave(const char* data, size_t size, bool hasGrowthConfig = true);
+
+        //Writes the tree in the packed save format described in SaveFormat.h. Rounding the geometry makes the
+        //save smaller but changes the tree slightly when it is loaded.
+        void writePackedSave(ostream& stream, bool quantizeGeometry) const;
+        //Creates a tree from packed save data, or returns nullptr if the data is not a valid tree. As with fromSave(),
+        //older saves have no growth config.
+        static Tree* fromPackedSave(const char* data, size_t size, bool quantizedGeometry, bool hasGrowthConfig = true);
 
 
     private:
-        vector<Branch*> branchList;
+        //Branches are stored by value in a persistent vector, so copies of the tree share them. The positions of
+        //the branches are a cache that resolvePositions() brings up to date, so it can change them in const functions.
+        mutable PersistentVector<Branch> branchList;
+
+        //The position of each branch in the branch list, by branch index, or -1 if the branch is not in the tree
+        PersistentVector<int> branchPositions;
+
+        //Changes the branch at a position by calling change() on it, keeping the hash of the branches up to date.
+        //Used for changes to a few branches, such as pruning.
+        template <typename Change>
+        void changeBranch(int position, Change change){
+            branchHash -= branchList[position].getHash();
+            Branch& branch = branchList.modify(position);
+            change(branch);
+            branchHash += branch.getHash();
+        }
+
+        //Grows the tree with the given growth policy from GrowthPolicy.h, which is inlined into the loop over the branches
+        template <typename GrowthPolicy>
+        void growWith(float &waterConsumed, float &nutrientsConsumed,
+        vector<float> &widthIncreases, vector<float> &lengthIncreases, vector<int> &branchesGrown);
+
+        //Works out the hash of the branches from scratch, after changes that affect most of the branches
+        void rehashBranches();
+
+        //Records that every branch may have changed size, so every branch is moved when the positions are resolved
+        void branchesResized();
+
+        //Moves the children of each branch in the given positions to its tip, and then their children, and so on
+        void moveChildren(vector<int> branchesToMove) const;
+
+        //Returns true if a new branch growing from the branch at the given position would overlap any branch in the
+        //grid other than its parent and the parent's other children, which all touch it where it starts
+        bool overlapsBranches(const Branch& newBranch, int parentPosition, const SpatialHash& branchGrid) const;
+
+        //Works out the supply of the branches whose supply may have changed since it was last worked out
+        void resolveSupply() const;
+
+        //Shares out the given inflow of each branch in the given positions between it and its children, and then does
+        //the same for their children, and so on
+        void shareSupply(vector<pair<int, float>> branchesToShare) const;
+
+        //Records that the supply of the branch at a position and every branch below it has changed, because it has
+        //been added to or removed from the tree. Adding or removing a branch with no parent changes every branch.
+        void supplyChanged(int position);
+
+        //Adds a branch to the end of the branch list
+        void appendBranch(const Branch& newBranch);
+
+        //Removes the branch at a position by moving the last branch into its place
+        void removeBranchAt(int position);
+
+        //Records the position of a branch in the branch list
+        void setBranchPosition(int index, int position);
+
+        //Returns true if the parent of every branch, unless it is -1, and every child is in the tree, and following
+        //the parents of any branch reaches a root. Used to check loaded trees before they are trusted.
+        bool hasValidLinks() const;
+
+        //Returns true if the branch at a position has no parent in the tree, which includes a trunk that is its
+        //own parent. These branches are never moved by resolvePositions().
+        bool isRootBranch(int position) const;
+
+        //Returns a random number from 0 up to 1, advancing the random state
+        float randomFraction();
 
         int maxIndex;
+        unsigned int randomState;
         float waterLevel;
         float maxWater;
         float nutrientLevel;
         float maxNutrients;
+
+        GrowthConfig growthConfig;
+
+        //Sum of the hashes of every branch, which does not depend on the order of the branch list
+        unsigned int branchHash;
+
+        //Indices of the branches whose children have to be moved when the positions are resolved, unless every
+        //branch has to be moved
+        mutable vector<int> movedBranches;
+        mutable bool allBranchesMoved = false;
+
+        //The supply of each branch, by branch index, which is worked out when it is needed in the same way as the
+        //positions of the branches
+        mutable PersistentVector<BranchSupply> branchSupplies;
+        mutable vector<int> resuppliedBranches;
+        mutable bool allBranchesResupplied = true;
 };
 
 #endif
\ No newline at end of file
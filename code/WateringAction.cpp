@@ -19,8 +19,31 @@ void WateringAction::reverseAction() {
     playerToModify->addWater(waterAdded);
 }
 
+void WateringAction::redoAction() {
+    //Watering is deterministic, so it is simply performed again
+    performAction();
+}
+
 void WateringAction::printData(){
     cout << "Watering Action object" << endl;
     cout << "Water Added: " << waterAdded << endl;
     cout << "Water absorbed: " << waterAbsorbed << endl;
-}
\ No newline at end of file
+}
+
+ActionType WateringAction::getType(){
+    return WATER_ACTION;
+}
+
+float WateringAction::getCommandAmount(){
+    return waterAdded;
+}
+
+void WateringAction::writeToJournal(ostream& journal){
+    writeValue(journal, waterAdded);
+    writeValue(journal, waterAbsorbed);
+}
+
+void WateringAction::readFromJournal(istream& journal){
+    waterAdded = readValue<float>(journal);
+    waterAbsorbed = readValue<float>(journal);
+}
@@ -6,14 +6,20 @@
 #include "Tree.h"
 #include "Player.h"
 
-class WateringAction : public Action, public Printable{
+class WateringAction : public Printable{
 public:
     WateringAction(Player* currentPlayer, Tree* currentTree, float litresToAdd);
 
-    virtual bool performAction();
-    virtual void reverseAction();
+    bool performAction();
+    void reverseAction();
+    void redoAction();
     virtual void printData();
 
+    ActionType getType();
+    float getCommandAmount();
+    void writeToJournal(ostream& journal);
+    void readFromJournal(istream& journal);
+
 protected:
     Player* playerToModify;
     Tree* treeToModify;
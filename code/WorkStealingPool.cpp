@@ -0,0 +1,126 @@
+#include "WorkStealingPool.h"
+
+WorkStealingPool::WorkStealingPool(int numThreads) : runNumber(0), activeWorkers(0), tasksRemaining(0), numStolen(0), stopping(false){
+    if(numThreads < 1){
+        numThreads = 1;
+    }
+
+    for(int i = 0; i < numThreads; i++){
+        queues.push_back(unique_ptr<TaskQueue>(new TaskQueue()));
+    }
+    for(int i = 0; i < numThreads; i++){
+        workers.push_back(thread(&WorkStealingPool::workerLoop, this, i));
+    }
+}
+
+WorkStealingPool::~WorkStealingPool(){
+    {
+        lock_guard<mutex> lock(runMutex);
+        stopping = true;
+    }
+    runStarted.notify_all();
+
+    for(int i = 0; i < workers.size(); i++){
+        workers[i].join();
+    }
+}
+
+void WorkStealingPool::run(int numTasks, function<void(int)> task){
+    if(numTasks <= 0){
+        return;
+    }
+
+    unique_lock<mutex> lock(runMutex);
+
+    //Each thread starts with a block of neighbouring tasks
+    int numThreads = queues.size();
+    for(int worker = 0; worker < numThreads; worker++){
+        int firstTask = (long long)numTasks*worker/numThreads;
+        int lastTask = (long long)numTasks*(worker+1)/numThreads;
+
+        lock_guard<mutex> queueLock(queues[worker]->queueMutex);
+        for(int i = firstTask; i < lastTask; i++){
+            queues[worker]->tasks.push_back(i);
+        }
+    }
+
+    currentTask = task;
+    tasksRemaining = numTasks;
+    runNumber++;
+    runStarted.notify_all();
+
+    //Also waits for every thread to stop looking for tasks, so none of them can take a task from the next run
+    //while still holding this one
+    runFinished.wait(lock, [this]{ return tasksRemaining == 0 && activeWorkers == 0; });
+    currentTask = nullptr;
+}
+
+int WorkStealingPool::getNumThreads(){
+    return workers.size();
+}
+
+long long WorkStealingPool::getNumStolen(){
+    return numStolen;
+}
+
+void WorkStealingPool::workerLoop(int worker){
+    int lastRun = 0;
+    while(true){
+        function<void(int)> task;
+        {
+            unique_lock<mutex> lock(runMutex);
+            runStarted.wait(lock, [&]{ return stopping || runNumber != lastRun; });
+            if(stopping){
+                return;
+            }
+            lastRun = runNumber;
+            task = currentTask;
+
+            //A thread that wakes after its run has already finished has nothing to do
+            if(!task){
+                continue;
+            }
+            activeWorkers++;
+        }
+
+        int taskNumber;
+        while(takeTask(worker, taskNumber)){
+            task(taskNumber);
+            tasksRemaining--;
+        }
+
+        //The last thread to run out of tasks wakes the caller
+        lock_guard<mutex> lock(runMutex);
+        activeWorkers--;
+        if(activeWorkers == 0 && tasksRemaining == 0){
+            runFinished.notify_one();
+        }
+    }
+}
+
+bool WorkStealingPool::takeTask(int worker, int& task){
+    {
+        TaskQueue& ownQueue = *queues[worker];
+        lock_guard<mutex> lock(ownQueue.queueMutex);
+        if(!ownQueue.tasks.empty()){
+            task = ownQueue.tasks.back();
+            ownQueue.tasks.pop_back();
+            return true;
+        }
+    }
+
+    //Tries every other thread, starting with the next one so that the threads do not all steal from the same queue
+    int numThreads = queues.size();
+    for(int i = 1; i < numThreads; i++){
+        TaskQueue& otherQueue = *queues[(worker+i) % numThreads];
+        lock_guard<mutex> lock(otherQueue.queueMutex);
+        if(!otherQueue.tasks.empty()){
+            task = otherQueue.tasks.front();
+            otherQueue.tasks.pop_front();
+            numStolen++;
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,65 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <functional>
+
+using namespace std;
+
+//Runs many tasks of very different lengths on a fixed set of threads. The tasks are shared out evenly between
+//the threads, and a thread that runs out of tasks takes the oldest tasks waiting for another thread, so one
+//thread is never left with all of the slow tasks while the others wait.
+class WorkStealingPool {
+    public:
+        //Starts the threads, which wait until tasks are given to them
+        WorkStealingPool(int numThreads);
+        //Stops the threads, which must not be running any tasks
+        ~WorkStealingPool();
+
+        //Calls the task once for every number from 0 up to numTasks, spread across the threads, and returns once
+        //every call has finished. Tasks with numbers close together start on the same thread.
+        void run(int numTasks, function<void(int)> task);
+
+        int getNumThreads();
+
+        //Returns the number of tasks that were taken from another thread's queue, since the pool was created
+        long long getNumStolen();
+
+    private:
+        //The tasks waiting for one thread. The thread takes its own tasks from the back and other threads steal from
+        //the front, so they rarely want the same task.
+        struct TaskQueue {
+            mutex queueMutex;
+            deque<int> tasks;
+        };
+
+        void workerLoop(int worker);
+
+        //Takes a task from the thread's own queue, or steals one from another queue. Returns false if every queue is empty.
+        bool takeTask(int worker, int& task);
+
+        vector<thread> workers;
+        vector<unique_ptr<TaskQueue>> queues;
+
+        //Protects the task being run and wakes the threads when a run starts and the caller when it finishes
+        mutex runMutex;
+        condition_variable runStarted;
+        condition_variable runFinished;
+
+        function<void(int)> currentTask;
+        //Increases with every run, so each thread knows when there are new tasks
+        int runNumber;
+        //Number of threads that are taking tasks from the current run
+        int activeWorkers;
+        atomic<int> tasksRemaining;
+        atomic<long long> numStolen;
+        bool stopping;
+};
+
+#endif
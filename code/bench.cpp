@@ -0,0 +1,392 @@
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cstdio>
+#include <cmath>
+#include <sys/resource.h>
+#include "Tree.h"
+#include "JsonWriter.h"
+#include "SaveFormat.h"
+#include "TimelapseExporter.h"
+#include "Forest.h"
+#include <thread>
+#include <opencv2/videoio.hpp>
+#include "include/nlohmann/json.hpp"
+
+using namespace std;
+
+//Number of branches in the tree that is saved and loaded
+const int BENCH_NUM_BRANCHES = 100000;
+
+//Builds a tree where every branch has two children, until it has the given number of branches
+Tree* buildTree(int numBranches){
+    vector<Branch> branches;
+    for(int i = 0; i < numBranches; i++){
+        Branch branch(i, (i-1)/2, 30*(i%3)-30, 50, 10, 0, 0);
+        if(i == 0){
+            branch = Branch(0, -1, 0, 50, 10, 0, 0);
+        }
+        for(int child = 2*i+1; child <= 2*i+2 && child < numBranches; child++){
+            branch.addChild(child);
+        }
+        branches.push_back(branch);
+    }
+
+    Tree* tree = new Tree(10, 10, new Branch(branches[0]), 1);
+    branches.erase(branches.begin());
+    tree->addBranches(branches);
+    tree->updateBranchPos();
+
+    return tree;
+}
+
+//Returns the highest amount of memory the program has used so far, in kilobytes
+long getPeakMemory(){
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+//Returns the size of a file in bytes
+long getFileSize(const char* path){
+    ifstream file(path, ios::binary | ios::ate);
+    return file.tellg();
+}
+
+//Writes and loads a save, printing the time taken, the size of the file and whether it loaded back the same.
+//Quantized saves round the geometry, so they only have to put the last branch within a pixel of where it was.
+void benchSaveFormat(string name, string path, Tree* tree, Player* player, bool quantizeGeometry){
+    auto start = chrono::steady_clock::now();
+    if(quantizeGeometry){
+        writePackedSave(path, tree, player, true);
+    }else{
+        writeSave(path, tree, player);
+    }
+    double saveTime = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    Tree* loadedTree = nullptr;
+    Player* loadedPlayer = nullptr;
+    start = chrono::steady_clock::now();
+    loadSave(path, loadedTree, loadedPlayer);
+    double loadTime = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    bool matches = loadedTree != nullptr;
+    if(matches && quantizeGeometry){
+        loadedTree->resolvePositions();
+        //The last branch is the furthest from the trunk, so its rounding errors are the largest
+        const Branch* branch = tree->getBranch(BENCH_NUM_BRANCHES-1);
+        const Branch* loadedBranch = loadedTree->getBranch(BENCH_NUM_BRANCHES-1);
+        float tipX, tipY, loadedTipX, loadedTipY;
+        branch->getTipPos(tipX, tipY);
+        matches = loadedBranch != nullptr;
+        if(matches){
+            loadedBranch->getTipPos(loadedTipX, loadedTipY);
+            matches = abs(tipX - loadedTipX) < 1 && abs(tipY - loadedTipY) < 1;
+        }
+    }else if(matches){
+        matches = loadedTree->getChecksum() == tree->getChecksum();
+    }
+
+    cout << name << ": " << getFileSize(path.c_str()) << " bytes, saved in " << saveTime << "ms, loaded in "
+         << loadTime << "ms" << (matches ? "" : ", tree does not match") << endl;
+
+    delete loadedTree;
+    delete loadedPlayer;
+    remove(path.c_str());
+}
+
+//Loads a JSON save of a tree with the given number of branches with the single pass reader, printing the time
+//taken and the speed
+void benchJsonLoad(int numBranches){
+    Tree* tree = buildTree(numBranches);
+    Player player(10, 5);
+    writeJsonSave("bench_load.json", tree, &player);
+    double megabytes = getFileSize("bench_load.json") / 1e6;
+
+    Tree* loadedTree = nullptr;
+    Player* loadedPlayer = nullptr;
+    auto start = chrono::steady_clock::now();
+    loadJsonSave("bench_load.json", loadedTree, loadedPlayer);
+    double readerTime = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    bool readerMatches = loadedTree != nullptr && loadedTree->getChecksum() == tree->getChecksum();
+    delete loadedTree;
+    delete loadedPlayer;
+
+    cout << "Loading " << numBranches << " branches with the single pass reader: " << readerTime << "ms, "
+         << megabytes*1000/readerTime << "MB/s" << (readerMatches ? "" : ", tree does not match") << endl;
+
+    remove("bench_load.json");
+    delete tree;
+}
+
+//Number of times the tree grows in the exported time-lapse
+const int BENCH_TIMELAPSE_GENERATIONS = 1000;
+
+//Exports a time-lapse of a tree that is watered and grown many times, and compares it with only encoding the same
+//number of frames, which is the fastest that the export could be
+void benchTimelapse(){
+    Tree* startTree = buildTree(15);
+    TimelineSave save = {*startTree, Player(10, 5)};
+    for(int i = 0; i < BENCH_TIMELAPSE_GENERATIONS; i++){
+        save.commands.push_back(make_pair(WATER_ACTION, 2.0f));
+        save.commands.push_back(make_pair(GROW_ACTION, 0.0f));
+    }
+    int numFrames = save.commands.size()+1;
+
+    auto start = chrono::steady_clock::now();
+    bool exported = exportTimelapse(save, "bench_timelapse.avi");
+    double exportTime = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    {
+        cv::VideoWriter video("bench_encode.avi", cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), TIMELAPSE_FRAMES_PER_SECOND,
+            cv::Size(TIMELAPSE_WIDTH, TIMELAPSE_HEIGHT));
+        cv::Mat frame(TIMELAPSE_HEIGHT, TIMELAPSE_WIDTH, CV_8UC3);
+        renderTimelapseFrame(*startTree, 0, frame);
+        for(int i = 0; i < numFrames; i++){
+            video.write(frame);
+        }
+    }
+    double encodeTime = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    cout << "Exporting " << numFrames << " time-lapse frames: " << exportTime << "ms, " << numFrames*1000/exportTime
+         << " frames/s" << (exported ? "" : ", export failed") << endl;
+    cout << "Only encoding " << numFrames << " frames: " << encodeTime << "ms, " << numFrames*1000/encodeTime << " frames/s" << endl;
+
+    remove("bench_timelapse.avi");
+    remove("bench_encode.avi");
+    delete startTree;
+}
+
+//Number of trees and generations in the forest benchmark
+const int BENCH_FOREST_TREES = 2000;
+const int BENCH_FOREST_GENERATIONS = 20;
+
+//Grows the same forest on more and more threads, printing the speed up over one thread
+void benchForest(){
+    int maxThreads = max(1u, thread::hardware_concurrency());
+    double oneThreadTime = 0;
+    for(int numThreads = 1; numThreads <= maxThreads; numThreads *= 2){
+        //The supplies differ between trees, so some trees grow far larger than others
+        Forest forest(numThreads);
+        for(int i = 0; i < BENCH_FOREST_TREES; i++){
+            forest.addTree(i, 15, 5 + i%40, 5 + i%40);
+        }
+
+        long long branchesGrown = 0;
+        auto start = chrono::steady_clock::now();
+        for(int generation = 0; generation < BENCH_FOREST_GENERATIONS; generation++){
+            branchesGrown += forest.growGeneration().totalBranches;
+        }
+        double time = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        if(numThreads == 1){
+            oneThreadTime = time;
+        }
+
+        cout << "Forest of " << BENCH_FOREST_TREES << " trees on " << numThreads << " threads: " << time << "ms, "
+             << branchesGrown*1000/time << " branches/s, " << oneThreadTime/time << "x the speed of one thread, "
+             << forest.getNumStolen() << " trees stolen" << endl;
+    }
+}
+
+//Number of branches and growth steps in the growth law benchmark
+const int BENCH_GROWTH_BRANCHES = 20000;
+const int BENCH_GROWTH_STEPS = 10;
+
+//Grows the same tree with each growth law, which each have their own copy of the growth loop
+void benchGrowthLaws(){
+    const char* lawNames[] = {"Quadratic", "Linear", "Logistic"};
+    for(int law = QUADRATIC_GROWTH; law <= LOGISTIC_GROWTH; law++){
+        Tree* growthTree = buildBinaryTree(BENCH_GROWTH_BRANCHES, 1);
+        GrowthConfig config;
+        config.growthLaw = (GrowthLaw)law;
+        growthTree->setGrowthConfig(config);
+
+        long long branchesGrown = 0;
+        auto start = chrono::steady_clock::now();
+        for(int step = 0; step < BENCH_GROWTH_STEPS; step++){
+            float waterConsumed;
+            float nutrientsConsumed;
+            vector<float> widthIncreases;
+            vector<float> lengthIncreases;
+            vector<int> newBranches;
+            growthTree->addWater(1000);
+            growthTree->addNutrients(1000);
+            branchesGrown += growthTree->getNumBranches();
+            growthTree->grow(waterConsumed, nutrientsConsumed, widthIncreases, lengthIncreases, newBranches);
+        }
+        double time = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+        cout << lawNames[law] << " growth of " << BENCH_GROWTH_BRANCHES << " branches for " << BENCH_GROWTH_STEPS
+             << " steps: " << time << "ms, " << branchesGrown*1000/time << " branches/s" << endl;
+        delete growthTree;
+    }
+}
+
+//Number of growth steps and prunes in the supply model benchmark
+const int BENCH_SUPPLY_STEPS = 3;
+const int BENCH_SUPPLY_PRUNES = 20;
+
+//Grows a large tree with each supply model, then prunes it, which only shares out the supply below the cut again
+void benchSupplyModels(){
+    const char* modelNames[] = {"Even", "Vascular"};
+    for(int model = EVEN_SUPPLY; model <= VASCULAR_SUPPLY; model++){
+        Tree* supplyTree = buildBinaryTree(BENCH_NUM_BRANCHES, 1);
+        GrowthConfig config;
+        config.supplyModel = (SupplyModel)model;
+        supplyTree->setGrowthConfig(config);
+
+        long long branchesGrown = 0;
+        auto start = chrono::steady_clock::now();
+        for(int step = 0; step < BENCH_SUPPLY_STEPS; step++){
+            float waterConsumed;
+            float nutrientsConsumed;
+            vector<float> widthIncreases;
+            vector<float> lengthIncreases;
+            vector<int> newBranches;
+            supplyTree->addWater(1000);
+            supplyTree->addNutrients(1000);
+            branchesGrown += supplyTree->getNumBranches();
+            supplyTree->grow(waterConsumed, nutrientsConsumed, widthIncreases, lengthIncreases, newBranches);
+        }
+        double time = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+        cout << modelNames[model] << " supply growth of " << BENCH_NUM_BRANCHES << " branches: " << time/BENCH_SUPPLY_STEPS
+             << "ms per step, " << branchesGrown*1000/time << " branches/s" << endl;
+
+        if(model == VASCULAR_SUPPLY){
+            //Each prune is deep in the tree, so only a few branches are shared out again
+            supplyTree->getSupplyShare(0);
+            start = chrono::steady_clock::now();
+            for(int i = 0; i < BENCH_SUPPLY_PRUNES; i++){
+                DetachedBranches removedBranches;
+                supplyTree->pruneBranch(BENCH_NUM_BRANCHES/2 + i, removedBranches);
+                supplyTree->getSupplyShare(0);
+            }
+            time = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            cout << "Sharing out the supply again after a prune: " << time/BENCH_SUPPLY_PRUNES << "ms each" << endl;
+        }
+        delete supplyTree;
+    }
+}
+
+//Number of random angles tried for each new branch in the overlap benchmark
+const int BENCH_SPROUT_ATTEMPTS = 8;
+
+//Grows trees of two sizes while avoiding overlaps, to show that the time taken for each new branch barely changes
+//as the tree gets larger
+void benchOverlapAvoidance(){
+    for(int numBranches : {BENCH_GROWTH_BRANCHES, BENCH_NUM_BRANCHES}){
+        for(int avoid = 0; avoid < 2; avoid++){
+            Tree* overlapTree = buildBinaryTree(numBranches, 1);
+            GrowthConfig config;
+            config.sproutAttempts = avoid*BENCH_SPROUT_ATTEMPTS;
+            overlapTree->setGrowthConfig(config);
+
+            float waterConsumed;
+            float nutrientsConsumed;
+            vector<float> widthIncreases;
+            vector<float> lengthIncreases;
+            vector<int> newBranches;
+            //Fills the tree, so it has enough left after growing for new branches
+            overlapTree->addWater(numBranches*10);
+            overlapTree->addNutrients(numBranches*10);
+            auto start = chrono::steady_clock::now();
+            overlapTree->grow(waterConsumed, nutrientsConsumed, widthIncreases, lengthIncreases, newBranches);
+            double time = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+            cout << "Growing " << numBranches << " branches " << (avoid ? "avoiding" : "ignoring") << " overlaps: " << time
+                 << "ms, " << newBranches.size() << " new branches" << endl;
+            delete overlapTree;
+        }
+    }
+}
+
+//Number of times the branch positions are updated in the position benchmark
+const int BENCH_POSITION_UPDATES = 20;
+
+//Moves every branch of a large tree to the tip of its parent, as happens after every growth step
+void benchUpdateBranchPos(Tree* tree){
+    auto start = chrono::steady_clock::now();
+    for(int i = 0; i < BENCH_POSITION_UPDATES; i++){
+        tree->updateBranchPos();
+    }
+    double time = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    cout << "Updating the positions of " << tree->getNumBranches() << " branches: " << time/BENCH_POSITION_UPDATES
+         << "ms each, " << tree->getNumBranches()*BENCH_POSITION_UPDATES*1000.0/time << " branches/s" << endl;
+
+    //Undoing a prune only has to move the subtree that is put back, rather than the whole tree. The pruned branch
+    //is deep in the tree, so its subtree is small.
+    start = chrono::steady_clock::now();
+    for(int i = 0; i < BENCH_POSITION_UPDATES; i++){
+        DetachedBranches removedBranches;
+        tree->pruneBranch(tree->getNumBranches()/8, removedBranches);
+        tree->restoreBranches(removedBranches);
+        tree->resolvePositions();
+    }
+    time = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    cout << "Pruning a small subtree and putting it back: " << time/BENCH_POSITION_UPDATES << "ms each" << endl;
+}
+
+int main(){
+    Tree* tree = buildTree(BENCH_NUM_BRANCHES);
+    cout << "Saving a tree with " << BENCH_NUM_BRANCHES << " branches" << endl;
+
+    //The streaming writer is measured first, as the peak memory can only go up
+    long memoryBefore = getPeakMemory();
+    auto start = chrono::steady_clock::now();
+    {
+        ofstream file("bench_stream.json");
+        JsonWriter writer(file);
+        tree->writeJson(writer);
+    }
+    double streamTime = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    long streamMemory = getPeakMemory() - memoryBefore;
+
+    memoryBefore = getPeakMemory();
+    start = chrono::steady_clock::now();
+    {
+        ofstream file("bench_dom.json");
+        file << tree->toJson().dump();
+    }
+    double domTime = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    long domMemory = getPeakMemory() - memoryBefore;
+
+    cout << "Streaming writer: " << streamTime << "ms, " << streamMemory << "KB extra peak memory, "
+         << getFileSize("bench_stream.json") << " bytes" << endl;
+    cout << "JSON object and dump(): " << domTime << "ms, " << domMemory << "KB extra peak memory, "
+         << getFileSize("bench_dom.json") << " bytes" << endl;
+
+    //Compares writing and loading the same game in each save format
+    Player player(10, 5);
+    benchSaveFormat("JSON save", "bench_save.json", tree, &player, false);
+    benchSaveFormat("Binary save", "bench_save.bin", tree, &player, false);
+    benchSaveFormat("Packed save", "bench_save.pack", tree, &player, false);
+    benchSaveFormat("Packed save with quantized geometry", "bench_quantized.pack", tree, &player, true);
+
+    //Measures the single pass JSON reader
+    benchJsonLoad(10000);
+    benchJsonLoad(100000);
+
+    //Compares exporting a time-lapse with the speed of the video encoder alone
+    benchTimelapse();
+
+    //Shows how growing a forest scales with the number of threads
+    benchForest();
+
+    //Compares the speed of the growth laws
+    benchGrowthLaws();
+    benchSupplyModels();
+    benchOverlapAvoidance();
+
+    //Measures moving every branch, which uses the direction stored in each branch
+    benchUpdateBranchPos(tree);
+
+    remove("bench_stream.json");
+    remove("bench_dom.json");
+    delete tree;
+
+    return 0;
+}
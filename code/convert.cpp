@@ -0,0 +1,21 @@
+#include <iostream>
+#include "SaveFormat.h"
+
+using namespace std;
+
+//Converts a save between the JSON, packed and binary formats
+int main(int argc, char* argv[]){
+    if(argc != 3){
+        cout << "Usage: " << argv[0] << " <input save> <output save>" << endl;
+        cout << "Files ending in .json are JSON saves, files ending in .pack are packed saves, and any other file is a binary save" << endl;
+        return 1;
+    }
+
+    if(!convertSave(argv[1], argv[2])){
+        cout << "Could not convert " << argv[1] << " to " << argv[2] << endl;
+        return 1;
+    }
+
+    cout << "Converted " << argv[1] << " to " << argv[2] << endl;
+    return 0;
+}
@@ -0,0 +1,262 @@
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <chrono>
+#include <random>
+#include <thread>
+#include "Tree.h"
+#include "Player.h"
+#include "Timeline.h"
+#include "ActionRecord.h"
+#include "SaveFormat.h"
+#include "Forest.h"
+#include "ParameterSweep.h"
+
+using namespace std;
+
+//Settings for a run of the simulation, which are given on the command line
+struct SimulationSettings {
+    int numSteps = 1000;
+    //Number of branches in the tree at the start, which is ignored when a save is loaded
+    int numBranches = 1;
+    //Water and fertiliser given before every step. The tree only absorbs up to what it can store.
+    float waterPerStep = 10;
+    float fertiliserPerStep = 10;
+    //Prunes a random branch after this many steps, or never if it is 0
+    int pruneInterval = 0;
+    unsigned int seed = 1;
+    //Records every action in a timeline, as the game does, rather than performing them directly
+    bool useTimeline = false;
+    //Shows the messages that actions print, which are hidden by default as they slow the simulation down
+    bool verbose = false;
+    //Prints the state hash of the tree after every step, so the output of two runs or two builds can be compared
+    bool printHashes = false;
+    string savePath;
+    //Grows a forest of this many trees instead of a single tree, or a single tree if it is 0
+    int numTrees = 0;
+    //Threads used to grow a forest, which is every core by default
+    int numThreads = thread::hardware_concurrency();
+    //Parameters of the growth model given with --set, which change the game's defaults or the config of a loaded tree
+    vector<pair<string, float>> growthParameters;
+};
+
+//Returns the config with every parameter given on the command line set
+GrowthConfig applyGrowthParameters(GrowthConfig config, const SimulationSettings& settings){
+    for(int i = 0; i < settings.growthParameters.size(); i++){
+        setGrowthParameter(config, settings.growthParameters[i].first, settings.growthParameters[i].second);
+    }
+    return config;
+}
+
+void printUsage(const char* programName){
+    cout << "Usage: " << programName << " [options]" << endl;
+    cout << "  --steps <n>        Number of growth steps to run (default 1000)" << endl;
+    cout << "  --branches <n>     Number of branches in the starting tree (default 1)" << endl;
+    cout << "  --load <save>      Starts from the tree and player in a save instead" << endl;
+    cout << "  --water <litres>   Water given before every step (default 10)" << endl;
+    cout << "  --fertiliser <kg>  Fertiliser given before every step (default 10)" << endl;
+    cout << "  --prune-every <n>  Prunes a random branch every n steps (default never)" << endl;
+    cout << "  --seed <n>         Seed for growth and pruning (default 1)" << endl;
+    cout << "  --timeline         Records every action in a timeline, as the game does" << endl;
+    cout << "  --trees <n>        Grows a forest of n trees with different seeds and supplies instead" << endl;
+    cout << "  --threads <n>      Threads used to grow a forest (default every core)" << endl;
+    cout << "  --set <name>=<n>   Sets a parameter of the growth model, such as new-branch-probability=0.6. A loaded" << endl;
+    cout << "                     tree keeps the rest of the parameters it was saved with." << endl;
+    cout << "  --verbose          Shows the message printed by every action" << endl;
+    cout << "  --hashes           Prints the state hash after every step, to compare runs for exactly equal growth" << endl;
+}
+
+//Reads the settings from the command line, returning false if they are not valid
+bool readSettings(int argc, char* argv[], SimulationSettings& settings){
+    for(int i = 1; i < argc; i++){
+        string option = argv[i];
+        if(option == "--timeline"){
+            settings.useTimeline = true;
+            continue;
+        }
+        if(option == "--verbose"){
+            settings.verbose = true;
+            continue;
+        }
+        if(option == "--hashes"){
+            settings.printHashes = true;
+            continue;
+        }
+
+        //Every other option is followed by a value
+        if(i+1 == argc){
+            cout << "Error in readSettings(), " << option << " needs a value" << endl;
+            return false;
+        }
+        const char* value = argv[++i];
+        if(option == "--steps"){
+            settings.numSteps = atoi(value);
+        }else if(option == "--branches"){
+            settings.numBranches = atoi(value);
+        }else if(option == "--load"){
+            settings.savePath = value;
+        }else if(option == "--water"){
+            settings.waterPerStep = atof(value);
+        }else if(option == "--fertiliser"){
+            settings.fertiliserPerStep = atof(value);
+        }else if(option == "--prune-every"){
+            settings.pruneInterval = atoi(value);
+        }else if(option == "--trees"){
+            settings.numTrees = atoi(value);
+        }else if(option == "--threads"){
+            settings.numThreads = atoi(value);
+        }else if(option == "--seed"){
+            settings.seed = strtoul(value, nullptr, 10);
+        }else if(option == "--set"){
+            string parameter = value;
+            size_t equals = parameter.find('=');
+            //The parameter is tried on a config of its own to check that it exists
+            GrowthConfig checkedConfig;
+            if(equals == string::npos ||
+               !setGrowthParameter(checkedConfig, parameter.substr(0, equals), atof(parameter.substr(equals+1).c_str()))){
+                cout << "Error in readSettings(), " << parameter << " is not a growth parameter followed by = and a value" << endl;
+                return false;
+            }
+            settings.growthParameters.push_back(make_pair(parameter.substr(0, equals), getGrowthParameter(checkedConfig, parameter.substr(0, equals))));
+        }else{
+            cout << "Error in readSettings(), unknown option " << option << endl;
+            return false;
+        }
+    }
+
+    if(settings.numSteps < 0 || settings.numBranches < 1 || settings.pruneInterval < 0 || settings.numTrees < 0){
+        cout << "Error in readSettings(), the number of steps, branches, trees and steps between pruning cannot be negative" << endl;
+        return false;
+    }
+    return true;
+}
+
+//Performs an action on its own, or through the timeline if there is one
+void performAction(ActionRecord action, Timeline* timeline){
+    if(timeline){
+        timeline->performAction(move(action));
+    }else{
+        visitAction(action, [](auto& action){ action.performAction(); });
+    }
+}
+
+//Grows a forest for the given number of generations, printing the totals after every generation
+void simulateForest(const SimulationSettings& settings){
+    //Each tree has its own seed and is given between half and one and a half times the set water and fertiliser
+    Forest forest(settings.numThreads);
+    mt19937 supplyRandom(settings.seed);
+    uniform_real_distribution<float> supplyScale(0.5, 1.5);
+    for(int i = 0; i < settings.numTrees; i++){
+        float scale = supplyScale(supplyRandom);
+        forest.addTree(settings.seed + i, settings.numBranches, settings.waterPerStep*scale, settings.fertiliserPerStep*scale,
+            applyGrowthParameters(GrowthConfig(), settings));
+    }
+
+    long long branchesGrown = 0;
+    auto start = chrono::steady_clock::now();
+    for(int step = 1; step <= settings.numSteps; step++){
+        GenerationStats stats = forest.growGeneration();
+        branchesGrown += stats.totalBranches;
+
+        cout << "Generation " << stats.generation << ": " << stats.totalBranches << " branches (" << stats.minBranches
+             << " to " << stats.maxBranches << " per tree), area " << stats.totalArea << ", "
+             << stats.numWithered << " of " << stats.numTrees << " trees withered";
+        if(settings.printHashes){
+            cout << ", state hash " << stats.stateHash;
+        }
+        cout << endl;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "Grew " << settings.numTrees << " trees for " << settings.numSteps << " generations on " << forest.getNumThreads()
+         << " threads in " << seconds*1000 << "ms, with " << forest.getNumStolen() << " trees stolen between threads" << endl;
+    cout << "Throughput: " << settings.numTrees*(double)settings.numSteps/seconds << " trees/s, " << branchesGrown/seconds << " branches/s" << endl;
+}
+
+//Runs the growth model without the game window, so that experiments can be run on servers
+int main(int argc, char* argv[]){
+    SimulationSettings settings;
+    if(!readSettings(argc, argv, settings)){
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if(settings.numTrees > 0){
+        simulateForest(settings);
+        return 0;
+    }
+
+    Tree* tree = nullptr;
+    Player* player = nullptr;
+    if(settings.savePath.empty()){
+        tree = buildBinaryTree(settings.numBranches, settings.seed);
+        player = new Player(10, 5);
+    }else if(!loadSave(settings.savePath, tree, player)){
+        cout << "Could not load " << settings.savePath << endl;
+        return 1;
+    }
+    //Saves store the config that the tree was grown with, so only the parameters that were given are changed
+    tree->setGrowthConfig(applyGrowthParameters(tree->getGrowthConfig(), settings));
+
+    Timeline* timeline = settings.useTimeline ? new Timeline(tree, player) : nullptr;
+    mt19937 pruneRandom(settings.seed);
+
+    int startBranches = tree->getNumBranches();
+    long long branchesGrown = 0;
+    int numPruned = 0;
+
+    //Actions print a message every time they are performed, which is hidden unless asked for
+    streambuf* outputBuffer = cout.rdbuf();
+    if(!settings.verbose){
+        cout.rdbuf(nullptr);
+    }
+    ostream hashOutput(outputBuffer);
+
+    auto start = chrono::steady_clock::now();
+    for(int step = 1; step <= settings.numSteps; step++){
+        //The player is given what they use in each step, so the run never stops for lack of supplies.
+        //Fertilising also uses water.
+        player->addWater(settings.waterPerStep + settings.fertiliserPerStep);
+        player->addFertiliser(settings.fertiliserPerStep);
+
+        if(settings.waterPerStep > 0){
+            performAction(WateringAction(player, tree, settings.waterPerStep), timeline);
+        }
+        if(settings.fertiliserPerStep > 0){
+            performAction(FertilisingAction(player, tree, settings.fertiliserPerStep), timeline);
+        }
+
+        //Every branch is grown, so the work done by a step is the number of branches
+        branchesGrown += tree->getNumBranches();
+        performAction(GrowingAction(player, tree), timeline);
+
+        //The trunk is at position 0 and is never pruned
+        if(settings.pruneInterval > 0 && step % settings.pruneInterval == 0 && tree->getNumBranches() > 1){
+            int position = 1 + pruneRandom() % (tree->getNumBranches()-1);
+            performAction(PruningAction(tree, tree->getBranchIndexAt(position)), timeline);
+            numPruned++;
+        }
+
+        if(settings.printHashes){
+            hashOutput << "Step " << step << ": state hash " << tree->getStateHash() << endl;
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout.rdbuf(outputBuffer);
+
+    cout << "Ran " << settings.numSteps << " steps in " << seconds*1000 << "ms" << endl;
+    cout << "Throughput: " << settings.numSteps/seconds << " steps/s, " << branchesGrown/seconds << " branches/s" << endl;
+    cout << "Branches: " << startBranches << " at the start, " << tree->getNumBranches() << " at the end, "
+         << numPruned << " prunes" << endl;
+    cout << "Total branch area: " << tree->getTotalArea() << endl;
+    cout << "Player supplies: " << player->getWaterSupply() << " water, " << player->getFertiliserSupply() << " fertiliser" << endl;
+    cout << "Tree checksum: " << tree->getChecksum() << endl;
+    cout << "Tree state hash: " << tree->getStateHash() << endl;
+
+    delete timeline;
+    delete tree;
+    delete player;
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <chrono>
+#include "ParameterSweep.h"
+
+using namespace std;
+
+void printUsage(const char* programName){
+    cout << "Usage: " << programName << " [options]" << endl;
+    cout << "  --sweep <name>=<values>  Tries each of a comma separated list of values of a parameter, for example" << endl;
+    cout << "                           --sweep new-branch-probability=0.2,0.4,0.6. Every combination is tried." << endl;
+    cout << "  --set <name>=<value>     Sets a parameter for every config" << endl;
+    cout << "  --seeds <n>              Number of seeds to grow each config from (default 10)" << endl;
+    cout << "  --first-seed <n>         First seed, with the others following it (default 1)" << endl;
+    cout << "  --steps <n>              Number of growth steps for each tree (default 50)" << endl;
+    cout << "  --branches <n>           Number of branches in each tree at the start (default 1)" << endl;
+    cout << "  --water <litres>         Water given before every step (default 10)" << endl;
+    cout << "  --fertiliser <kg>        Nutrients given before every step (default 10)" << endl;
+    cout << "  --threads <n>            Threads used to grow the trees (default every core)" << endl;
+    cout << "Parameters:";
+    vector<string> names = getGrowthParameterNames();
+    for(int i = 0; i < names.size(); i++){
+        cout << " " << names[i];
+    }
+    cout << endl;
+}
+
+//Splits an option such as "name=1,2,3" into the name and the values, returning false if it is not valid
+bool readParameterValues(const string& option, string& name, vector<float>& values){
+    size_t equals = option.find('=');
+    if(equals == string::npos || equals == 0){
+        cout << "Error in readParameterValues(), " << option << " should be a parameter name followed by = and its values" << endl;
+        return false;
+    }
+    name = option.substr(0, equals);
+
+    GrowthConfig config;
+    if(!setGrowthParameter(config, name, 0)){
+        cout << "Error in readParameterValues(), there is no growth parameter called " << name << endl;
+        return false;
+    }
+
+    size_t start = equals+1;
+    while(start <= option.size()){
+        size_t comma = option.find(',', start);
+        if(comma == string::npos){
+            comma = option.size();
+        }
+        values.push_back(atof(option.substr(start, comma-start).c_str()));
+        start = comma+1;
+    }
+    return true;
+}
+
+//Grows trees with every combination of the swept parameters, so the growth model can be tuned without recompiling.
+//Prints one line of comma separated values for each config.
+int main(int argc, char* argv[]){
+    SweepSettings settings;
+    GrowthConfig baseConfig;
+    vector<pair<string, vector<float>>> sweptValues;
+
+    for(int i = 1; i < argc; i++){
+        string option = argv[i];
+        if(i+1 == argc){
+            cout << "Error in main(), " << option << " needs a value" << endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+        const char* value = argv[++i];
+
+        string name;
+        vector<float> values;
+        if(option == "--sweep" || option == "--set"){
+            if(!readParameterValues(value, name, values)){
+                printUsage(argv[0]);
+                return 1;
+            }
+            if(option == "--sweep"){
+                sweptValues.push_back(make_pair(name, values));
+            }else{
+                setGrowthParameter(baseConfig, name, values[0]);
+            }
+        }else if(option == "--seeds"){
+            settings.numSeeds = atoi(value);
+        }else if(option == "--first-seed"){
+            settings.firstSeed = strtoul(value, nullptr, 10);
+        }else if(option == "--steps"){
+            settings.numSteps = atoi(value);
+        }else if(option == "--branches"){
+            settings.numBranches = atoi(value);
+        }else if(option == "--water"){
+            settings.waterPerStep = atof(value);
+        }else if(option == "--fertiliser"){
+            settings.nutrientsPerStep = atof(value);
+        }else if(option == "--threads"){
+            settings.numThreads = atoi(value);
+        }else{
+            cout << "Error in main(), unknown option " << option << endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if(settings.numSeeds < 1 || settings.numSteps < 0 || settings.numBranches < 1){
+        cout << "Error in main(), there must be at least one seed and one branch, and the number of steps cannot be negative" << endl;
+        return 1;
+    }
+
+    vector<GrowthConfig> configs = buildConfigGrid(baseConfig, sweptValues);
+
+    auto start = chrono::steady_clock::now();
+    vector<SweepResult> results = runSweep(configs, settings);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    for(int i = 0; i < sweptValues.size(); i++){
+        cout << sweptValues[i].first << ",";
+    }
+    cout << "trees,mean branches,min branches,max branches,mean area,mean depth,withered,grow time (ms)" << endl;
+    for(int i = 0; i < results.size(); i++){
+        for(int j = 0; j < sweptValues.size(); j++){
+            cout << getGrowthParameter(results[i].config, sweptValues[j].first) << ",";
+        }
+        cout << results[i].numTrees << "," << results[i].meanBranches << "," << results[i].minBranches << ","
+             << results[i].maxBranches << "," << results[i].meanArea << "," << results[i].meanDepth << ","
+             << results[i].numWithered << "," << results[i].growTime << endl;
+    }
+
+    cout << "Swept " << configs.size() << " configs over " << settings.numSeeds << " seeds in " << seconds*1000
+         << "ms on " << max(settings.numThreads, 1) << " threads" << endl;
+    return 0;
+}
@@ -2,13 +2,23 @@
 #include "Player.h"
 #include "Printable.h"
 #include "Action.h"
+#include "ActionRecord.h"
 #include "Tree.h"
 #include "Branch.h"
 #include "Timeline.h"
+#include "SaveFormat.h"
+#include "BackgroundSaver.h"
+#include "SaveSlots.h"
+#include "TimelapseExporter.h"
+#include "Forest.h"
+#include "SimulationThread.h"
+#include "ParameterSweep.h"
 #include "GrowingAction.h"
 #include "WateringAction.h"
 #include "FertilisingAction.h"
 #include <vector>
+#include <sstream>
+#include <fstream>
 #include "PruningAction.h"
 #include "Clickable.h"
 #include <opencv2/opencv.hpp>
@@ -120,10 +130,19 @@ int main() {
     std::cout << "Nutrients consumed during growth: " << nutrientsConsumed << std::endl;
     tree.printData();
 
+    // Test that a copy of the tree keeps its state when the original changes
+    Tree treeSnapshot = tree;
+    tree.grow(waterConsumed, nutrientsConsumed, widthIncreases, lengthIncreases, branchesGrown);
+    if (treeSnapshot.getBranch(0)->getSize() < tree.getBranch(0)->getSize()) {
+        std::cout << "Passed: Tree snapshot is unchanged by growth" << std::endl;
+    } else {
+        std::cout << "Failed: Tree snapshot was changed by growth" << std::endl;
+    }
+
     // Test branch pruning
-    std::vector<Branch*> removedBranches;
+    DetachedBranches removedBranches;
     tree.pruneBranch(0, removedBranches); // Prune the trunk
-    std::cout << "Pruned branches: " << removedBranches.size() << std::endl;
+    std::cout << "Pruned branches: " << removedBranches.branches.size() << std::endl;
     tree.printData();
 
     // Indicate end of tests
@@ -255,8 +274,7 @@ int main() {
 
 
     // Perform the first action
-    Action* action = new GrowingAction(anotherPlayer, anotherTree);  // Placeholder, testing the framework with a null action
-    timeline.performAction(action);
+    timeline.performAction(GrowingAction(anotherPlayer, anotherTree));
     std::cout << "Performed an action successfully." << std::endl;
 
     // Reverse the last action
@@ -271,13 +289,999 @@ int main() {
 
     delete anotherTree;
 
+
+
+    //Test travelling back through checkpoints
+    trunk = new Branch(0, -1, 0, 50, 10, 0, 0);
+    Tree* travelTree = new Tree(10.0, 20.0, trunk);
+    Player* travelPlayer = new Player(100.0, 100.0);
+    Timeline* travelTimeline = new Timeline(travelTree, travelPlayer, 3);
+
+    //Stores the water supply after the second action to compare with later
+    travelTimeline->performAction(WateringAction(travelPlayer, travelTree, 1.0));
+    travelTimeline->performAction(WateringAction(travelPlayer, travelTree, 1.0));
+    float supplyAtStepTwo = travelPlayer->getWaterSupply();
+
+    //Performs enough actions to pass several checkpoints
+    for (int i = 0; i < 8; i++) {
+        travelTimeline->performAction(GrowingAction(travelPlayer, travelTree));
+    }
+
+    travelTimeline->travelTo(2);
+
+    if (travelTimeline->getCurrentStep() == 2 && travelPlayer->getWaterSupply() == supplyAtStepTwo) {
+        std::cout << "Passed: Timeline travelled back to step 2" << std::endl;
+    } else {
+        std::cout << "Failed: Timeline did not travel back to step 2" << std::endl;
+    }
+
+    travelTimeline->travelTo(0);
+
+    if (travelTimeline->getCurrentStep() == 0 && travelPlayer->getWaterSupply() == 100.0) {
+        std::cout << "Passed: Timeline travelled back to the beginning" << std::endl;
+    } else {
+        std::cout << "Failed: Timeline did not travel back to the beginning" << std::endl;
+    }
+
+    std::cout << "Time travel test complete \n" << std::endl;
+
+    delete travelTimeline;
+    delete travelTree;
+    delete travelPlayer;
+
+
+
+    //Test reversing actions that have been moved to the journal
+    trunk = new Branch(0, -1, 0, 50, 10, 0, 0);
+    Tree* journalTree = new Tree(10.0, 20.0, trunk);
+    Player* journalPlayer = new Player(100.0, 100.0);
+    Timeline* journalTimeline = new Timeline(journalTree, journalPlayer, 0);
+    journalTimeline->setMemoryBudget(2, "test.journal");
+
+    for (int i = 0; i < 6; i++) {
+        journalTimeline->performAction(GrowingAction(journalPlayer, journalTree));
+        journalTimeline->performAction(WateringAction(journalPlayer, journalTree, 1.0));
+    }
+    journalTimeline->printData();
+
+    //Reverses every action, most of which have to be read back from the journal
+    for (int i = 0; i < 12; i++) {
+        journalTimeline->reverseAction();
+    }
+
+    if (journalTimeline->getCurrentStep() == 0 && journalPlayer->getWaterSupply() == 100.0) {
+        std::cout << "Passed: Journalled actions were reversed" << std::endl;
+    } else {
+        std::cout << "Failed: Journalled actions were not reversed" << std::endl;
+    }
+
+    std::cout << "Journal test complete \n" << std::endl;
+
+    delete journalTimeline;
+    delete journalTree;
+    delete journalPlayer;
+
+
+
+    //Test redoing actions and switching between timelines
+    trunk = new Branch(0, -1, 0, 50, 10, 0, 0);
+    Tree* branchingTree = new Tree(10.0, 20.0, trunk);
+    Player* branchingPlayer = new Player(100.0, 100.0);
+    Timeline* branchingTimeline = new Timeline(branchingTree, branchingPlayer, 2);
+    branchingTimeline->setMemoryBudget(3, "branching.journal");
+
+    for (int i = 0; i < 5; i++) {
+        branchingTimeline->performAction(GrowingAction(branchingPlayer, branchingTree));
+    }
+    float supplyOnFirstTimeline = branchingPlayer->getWaterSupply();
+
+    //Reverses two actions and redoes one of them
+    branchingTimeline->reverseAction();
+    branchingTimeline->reverseAction();
+    branchingTimeline->redoAction();
+
+    if (branchingTimeline->getCurrentStep() == 4) {
+        std::cout << "Passed: Reversed action was redone" << std::endl;
+    } else {
+        std::cout << "Failed: Reversed action was not redone" << std::endl;
+    }
+
+    //Performing a new action after reversing starts a second timeline
+    branchingTimeline->performAction(WateringAction(branchingPlayer, branchingTree, 10.0));
+    float supplyOnSecondTimeline = branchingPlayer->getWaterSupply();
+    branchingTimeline->printTimelines();
+
+    branchingTimeline->switchTimeline(0);
+    if (branchingTimeline->getCurrentStep() == 5 && branchingPlayer->getWaterSupply() == supplyOnFirstTimeline) {
+        std::cout << "Passed: Switched back to the first timeline" << std::endl;
+    } else {
+        std::cout << "Failed: Did not switch back to the first timeline" << std::endl;
+    }
+
+    branchingTimeline->switchTimeline(1);
+    if (branchingTimeline->getCurrentStep() == 5 && branchingPlayer->getWaterSupply() == supplyOnSecondTimeline) {
+        std::cout << "Passed: Switched to the second timeline" << std::endl;
+    } else {
+        std::cout << "Failed: Did not switch to the second timeline" << std::endl;
+    }
+
+    std::cout << "Branching timeline test complete \n" << std::endl;
+
+    delete branchingTimeline;
+    delete branchingTree;
+    delete branchingPlayer;
+
+    //Test saving the commands of a timeline and replaying them to rebuild the tree
+    trunk = new Branch(0, -1, 0, 50, 10, 0, 0);
+    Tree* recordedTree = new Tree(10.0, 20.0, trunk, 42);
+    Player* recordedPlayer = new Player(100.0, 100.0);
+    Timeline* recordedTimeline = new Timeline(recordedTree, recordedPlayer);
+
+    recordedTimeline->performAction(WateringAction(recordedPlayer, recordedTree, 5));
+    for (int i = 0; i < 4; i++) {
+        recordedTimeline->performAction(GrowingAction(recordedPlayer, recordedTree));
+    }
+    recordedTimeline->performAction(FertilisingAction(recordedPlayer, recordedTree, 3));
+    recordedTimeline->performAction(GrowingAction(recordedPlayer, recordedTree));
+    recordedTimeline->performAction(PruningAction(recordedTree, 1));
+
+    std::stringstream savedTimelineStream;
+    {
+        JsonWriter writer(savedTimelineStream);
+        recordedTimeline->getSave().writeJson(writer);
+    }
+    std::string savedTimelineText = savedTimelineStream.str();
+    JsonReader savedTimelineReader(savedTimelineText.data(), savedTimelineText.size());
+    TimelineSave savedTimeline = TimelineSave::readJson(savedTimelineReader);
+
+    Tree* replayedTree = new Tree(savedTimeline.startTree);
+    Player* replayedPlayer = new Player(savedTimeline.startPlayer);
+    Timeline* replayedTimeline = new Timeline(replayedTree, replayedPlayer);
+    replayedTimeline->replayCommands(savedTimeline.commands);
+
+    if (replayedTree->getChecksum() == recordedTree->getChecksum()) {
+        std::cout << "Passed: Replaying the saved commands rebuilt the same tree" << std::endl;
+    } else {
+        std::cout << "Failed: Replaying the saved commands rebuilt a different tree" << std::endl;
+    }
+
+    //Actions that were undone are not saved, so the game after an undo must be the same as if they never happened
+    trunk = new Branch(0, -1, 0, 50, 10, 0, 0);
+    Tree* undoneTree = new Tree(10.0, 20.0, trunk, 7);
+    Player* undonePlayer = new Player(100.0, 100.0);
+    Timeline* undoneTimeline = new Timeline(undoneTree, undonePlayer, 4);
+    for (int i = 0; i < 12; i++) {
+        undoneTimeline->performAction(WateringAction(undonePlayer, undoneTree, 4));
+        undoneTimeline->performAction(GrowingAction(undonePlayer, undoneTree));
+        if (i % 4 == 3) {
+            undoneTimeline->reverseAction();
+        }
+    }
+    TimelineSave undoneSave = undoneTimeline->getSave();
+    writeJsonSave("test_undone.json", undoneTree, undonePlayer, &undoneSave);
+    Tree* loadedUndoneTree = nullptr;
+    Player* loadedUndonePlayer = nullptr;
+    bool undoneLoaded = loadJsonSave("test_undone.json", loadedUndoneTree, loadedUndonePlayer);
+
+    //A save whose checksum is of a different tree must be refused rather than loaded as the wrong game
+    writeJsonSave("test_undone.json", recordedTree, undonePlayer, &undoneSave);
+    Tree* mismatchedTree = nullptr;
+    Player* mismatchedPlayer = nullptr;
+    bool mismatchedLoaded = loadJsonSave("test_undone.json", mismatchedTree, mismatchedPlayer);
+
+    if (undoneLoaded && loadedUndoneTree->getChecksum() == undoneTree->getChecksum() &&
+        loadedUndonePlayer->getWaterSupply() == undonePlayer->getWaterSupply() &&
+        !mismatchedLoaded && mismatchedTree == nullptr) {
+        std::cout << "Passed: Compact save after undoing growth replayed to the same tree" << std::endl;
+    } else {
+        std::cout << "Failed: Compact save after undoing growth did not replay to the same tree" << std::endl;
+    }
+    remove("test_undone.json");
+    delete loadedUndoneTree;
+    delete loadedUndonePlayer;
+    delete undoneTimeline;
+    delete undoneTree;
+    delete undonePlayer;
+
+    //Undoing growth must also undo the random numbers it used, so growing again gives the same branches
+    unsigned int randomStateBeforeGrowth = replayedTree->getRandomState();
+    replayedTimeline->performAction(GrowingAction(replayedPlayer, replayedTree));
+    replayedTimeline->reverseAction();
+    if (replayedTree->getRandomState() == randomStateBeforeGrowth) {
+        std::cout << "Passed: Undoing growth restored the random state" << std::endl;
+    } else {
+        std::cout << "Failed: Undoing growth did not restore the random state" << std::endl;
+    }
+
+    //Undoing growth after the free water has been spent can only take back what is left, and redoing gives back the same
+    Player spendingPlayer(0, 0);
+    GrowingAction spentGrowth(&spendingPlayer, replayedTree);
+    spentGrowth.performAction();
+    spendingPlayer.useWater(1.5);
+    spentGrowth.reverseAction();
+    float waterAfterUndo = spendingPlayer.getWaterSupply();
+    spentGrowth.redoAction();
+    if (waterAfterUndo == 0 && spendingPlayer.getWaterSupply() == 0.5 && spendingPlayer.getFertiliserSupply() == 1) {
+        std::cout << "Passed: Undoing and redoing growth took back and gave back the same supplies" << std::endl;
+    } else {
+        std::cout << "Failed: Undoing and redoing growth did not take back and give back the same supplies" << std::endl;
+    }
+
+    //Trees written by the streaming writer must load back exactly
+    std::stringstream streamedTree;
+    {
+        JsonWriter writer(streamedTree);
+        recordedTree->writeJson(writer);
+    }
+    std::string streamedText = streamedTree.str();
+    JsonReader streamedReader(streamedText.data(), streamedText.size());
+    Tree* loadedTree = Tree::readJson(streamedReader);
+    if (loadedTree != nullptr && loadedTree->getChecksum() == recordedTree->getChecksum()) {
+        std::cout << "Passed: Streamed tree loaded back the same" << std::endl;
+    } else {
+        std::cout << "Failed: Streamed tree did not load back the same" << std::endl;
+    }
+    delete loadedTree;
+
+    //Invalid JSON must be reported at the line and column where it stops being valid
+    std::string invalidJson = "{\n  \"maxIndex\": 1,\n  \"branchList\": [{\"index\": 0,, \"age\": 1}]\n}";
+    JsonReader invalidReader(invalidJson.data(), invalidJson.size());
+    try {
+        delete Tree::readJson(invalidReader);
+        std::cout << "Failed: Invalid JSON was read without an error" << std::endl;
+    } catch (JsonReadError& e) {
+        if (e.line == 3 && e.column == 30) {
+            std::cout << "Passed: Invalid JSON was reported at the right position" << std::endl;
+        } else {
+            std::cout << "Failed: Invalid JSON was reported at " << e.what() << std::endl;
+        }
+    }
+
+    //Binary saves must load back exactly, including after converting to JSON and back
+    writeBinarySave("test.bin", recordedTree, recordedPlayer);
+    convertSave("test.bin", "test.json");
+    convertSave("test.json", "converted.bin");
+    Tree* binaryTree = nullptr;
+    Player* binaryPlayer = nullptr;
+    if (loadBinarySave("converted.bin", binaryTree, binaryPlayer) && binaryTree->getChecksum() == recordedTree->getChecksum() &&
+        binaryPlayer->getWaterSupply() == recordedPlayer->getWaterSupply()) {
+        std::cout << "Passed: Binary save loaded back the same after converting" << std::endl;
+    } else {
+        std::cout << "Failed: Binary save did not load back the same after converting" << std::endl;
+    }
+    delete binaryTree;
+    delete binaryPlayer;
+    remove("test.bin");
+    remove("test.json");
+    remove("converted.bin");
+
+    //Packed saves must load back exactly, and quantized ones must be smaller and keep every branch
+    writePackedSave("test.pack", recordedTree, recordedPlayer);
+    writePackedSave("test_quantized.pack", recordedTree, recordedPlayer, true);
+    Tree* packedTree = nullptr;
+    Player* packedPlayer = nullptr;
+    if (loadPackedSave("test.pack", packedTree, packedPlayer) && packedTree->getChecksum() == recordedTree->getChecksum() &&
+        packedPlayer->getFertiliserSupply() == recordedPlayer->getFertiliserSupply()) {
+        std::cout << "Passed: Packed save loaded back the same" << std::endl;
+    } else {
+        std::cout << "Failed: Packed save did not load back the same" << std::endl;
+    }
+    delete packedTree;
+    delete packedPlayer;
+
+    std::ifstream packedFile("test.pack", std::ios::binary | std::ios::ate);
+    std::ifstream quantizedFile("test_quantized.pack", std::ios::binary | std::ios::ate);
+    packedTree = nullptr;
+    packedPlayer = nullptr;
+    if (quantizedFile.tellg() < packedFile.tellg() && loadPackedSave("test_quantized.pack", packedTree, packedPlayer) &&
+        packedTree->toJson()["branchList"].size() == recordedTree->toJson()["branchList"].size()) {
+        std::cout << "Passed: Quantized packed save was smaller and kept every branch" << std::endl;
+    } else {
+        std::cout << "Failed: Quantized packed save was not smaller or lost branches" << std::endl;
+    }
+    delete packedTree;
+    delete packedPlayer;
+    remove("test.pack");
+    remove("test_quantized.pack");
+
+    std::cout << "Replay test complete \n" << std::endl;
+
+    //Test that undoing a prune puts the branches back exactly where they were
+    recordedTimeline->reverseAction();
+    unsigned int checksumBeforePruning = recordedTree->getChecksum();
+    int prunedParentIndex = recordedTree->getBranch(1)->getParentIndex();
+    vector<int> childrenBeforePruning = recordedTree->getBranch(prunedParentIndex)->getChildren();
+
+    DetachedBranches prunedSubtree;
+    recordedTree->pruneBranch(1, prunedSubtree);
+    if (recordedTree->getBranch(1) == nullptr && recordedTree->getBranch(prunedParentIndex)->getChildPosition(1) == -1) {
+        std::cout << "Passed: Pruned branch was detached from its parent" << std::endl;
+    } else {
+        std::cout << "Failed: Pruned branch is still attached to its parent" << std::endl;
+    }
+
+    recordedTree->restoreBranches(prunedSubtree);
+    if (recordedTree->getBranch(prunedParentIndex)->getChildren() == childrenBeforePruning &&
+        recordedTree->getChecksum() == checksumBeforePruning) {
+        std::cout << "Passed: Restored branches were put back in the same order" << std::endl;
+    } else {
+        std::cout << "Failed: Restored branches were not put back in the same order" << std::endl;
+    }
+
+    std::cout << "Prune restore test complete \n" << std::endl;
+
+    //Test continuing a game from its autosave snapshot and the changes recorded after it
+    trunk = new Branch(0, -1, 0, 50, 10, 0, 0);
+    Tree* autosavedTree = new Tree(10.0, 20.0, trunk, 7);
+    Player* autosavedPlayer = new Player(100.0, 100.0);
+    Timeline* autosavedTimeline = new Timeline(autosavedTree, autosavedPlayer);
+    autosavedTimeline->enableAutosave("test_autosave.json", "test_autosave.journal", 5);
+
+    for (int i = 0; i < 3; i++) {
+        autosavedTimeline->performAction(GrowingAction(autosavedPlayer, autosavedTree));
+    }
+    autosavedTimeline->reverseAction();
+    autosavedTimeline->reverseAction();
+    autosavedTimeline->performAction(WateringAction(autosavedPlayer, autosavedTree, 5));
+    autosavedTimeline->performAction(GrowingAction(autosavedPlayer, autosavedTree));
+    autosavedTimeline->travelTo(1);
+    autosavedTimeline->redoAction();
+    autosavedTimeline->switchTimeline(0);
+    autosavedTimeline->performAction(GrowingAction(autosavedPlayer, autosavedTree));
+    autosavedTimeline->performAction(FertilisingAction(autosavedPlayer, autosavedTree, 3));
+
+    unsigned int autosavedChecksum = autosavedTree->getChecksum();
+    int autosavedStep = autosavedTimeline->getCurrentStep();
+    float autosavedWater = autosavedPlayer->getWaterSupply();
+    delete autosavedTimeline;
+
+    trunk = new Branch(0, -1, 0, 50, 10, 0, 0);
+    Tree* recoveredTree = new Tree(10.0, 10.0, trunk);
+    Player* recoveredPlayer = new Player(10, 5);
+    Timeline* recoveredTimeline = new Timeline(recoveredTree, recoveredPlayer);
+    if (recoveredTimeline->recoverAutosave("test_autosave.json", "test_autosave.journal") &&
+        recoveredTree->getChecksum() == autosavedChecksum && recoveredTimeline->getCurrentStep() == autosavedStep &&
+        recoveredTimeline->getNumTimelines() == 2 && recoveredPlayer->getWaterSupply() == autosavedWater) {
+        std::cout << "Passed: Autosaved game was recovered" << std::endl;
+    } else {
+        std::cout << "Failed: Autosaved game was not recovered" << std::endl;
+    }
+
+    std::cout << "Autosave test complete \n" << std::endl;
+
+    //Test that a background save stores the game as it was when saving started, even while the game keeps changing
+    BackgroundSaver* saver = new BackgroundSaver();
+    unsigned int checksumWhenSaved = recoveredTree->getChecksum();
+    saver->startSave(new Tree(*recoveredTree), new Player(*recoveredPlayer),
+        new TimelineSave(recoveredTimeline->getSave()), "test_background.json");
+    recoveredTimeline->performAction(GrowingAction(recoveredPlayer, recoveredTree));
+    saver->wait();
+
+    Tree* backgroundTree = nullptr;
+    Player* backgroundPlayer = nullptr;
+    std::ifstream temporaryFile("test_background.json.tmp");
+    if (loadJsonSave("test_background.json", backgroundTree, backgroundPlayer) &&
+        backgroundTree->getChecksum() == checksumWhenSaved && !temporaryFile.is_open() && !saver->isSaving()) {
+        std::cout << "Passed: Background save stored the game as it was when saving started" << std::endl;
+    } else {
+        std::cout << "Failed: Background save did not store the game as it was when saving started" << std::endl;
+    }
+    delete saver;
+    delete backgroundTree;
+    delete backgroundPlayer;
+    remove("test_background.json");
+
+    std::cout << "Background save test complete \n" << std::endl;
+
+    //Test that the slot index keeps one entry per slot in order, replacing a slot that is saved again
+    remove("test_slots.index");
+    updateSaveSlotIndex("test_slots.index", createSaveSlotInfo(4, "Later slot", recoveredTree));
+    updateSaveSlotIndex("test_slots.index", createSaveSlotInfo(1, "First save", recoveredTree));
+    updateSaveSlotIndex("test_slots.index", createSaveSlotInfo(1, "Second save", &myTree));
+    vector<SaveSlotInfo> slots = readSaveSlotIndex("test_slots.index");
+    if (slots.size() == 2 && slots[0].slot == 1 && slots[1].slot == 4 && string(slots[0].name) == "Second save" &&
+        slots[0].numBranches == myTree.getNumBranches() && slots[1].numBranches == recoveredTree->getNumBranches()) {
+        std::cout << "Passed: Save slot index listed each slot once in order" << std::endl;
+    } else {
+        std::cout << "Failed: Save slot index did not list each slot once in order" << std::endl;
+    }
+    remove("test_slots.index");
+
+    std::cout << "Save slot test complete \n" << std::endl;
+
+    //Test that exporting a time-lapse as images writes one frame for the start and one for every action
+    TimelineSave timelapseSave = recoveredTimeline->getSave();
+    int numFrames = timelapseSave.commands.size()+1;
+    bool exported = exportTimelapse(timelapseSave, "test_timelapse.png", 200, 150);
+    int numImages = 0;
+    while (std::ifstream(getTimelapseImagePath("test_timelapse.png", numImages)).good()) {
+        remove(getTimelapseImagePath("test_timelapse.png", numImages).c_str());
+        numImages++;
+    }
+    if (exported && numImages == numFrames) {
+        std::cout << "Passed: Time-lapse exported a frame for every step" << std::endl;
+    } else {
+        std::cout << "Failed: Time-lapse did not export a frame for every step" << std::endl;
+    }
+
+    std::cout << "Time-lapse test complete \n" << std::endl;
+
+    //Test that growing a forest on several threads gives every tree the same result as growing it on one thread
+    Forest parallelForest(4);
+    Forest serialForest(1);
+    for (int i = 0; i < 40; i++) {
+        parallelForest.addTree(i, 1 + i%7, 10 + i%5, 10);
+        serialForest.addTree(i, 1 + i%7, 10 + i%5, 10);
+    }
+    GenerationStats parallelStats;
+    GenerationStats serialStats;
+    for (int i = 0; i < 8; i++) {
+        parallelStats = parallelForest.growGeneration();
+        serialStats = serialForest.growGeneration();
+    }
+    bool forestsMatch = parallelStats.totalBranches == serialStats.totalBranches && parallelStats.generation == 8;
+    for (int i = 0; i < 40; i++) {
+        forestsMatch = forestsMatch && parallelForest.getTree(i)->getChecksum() == serialForest.getTree(i)->getChecksum();
+    }
+    if (forestsMatch) {
+        std::cout << "Passed: Forest grew the same trees on several threads as on one" << std::endl;
+    } else {
+        std::cout << "Failed: Forest grew different trees on several threads than on one" << std::endl;
+    }
+
+    std::cout << "Forest test complete \n" << std::endl;
+
+    //Test that commands given to the simulation thread run in order and that the snapshot drawn afterwards matches the tree
+    Tree* simulatedTree = buildBinaryTree(15, 3);
+    Player* simulatedPlayer = new Player(1000, 1000);
+    Timeline* simulatedTimeline = new Timeline(simulatedTree, simulatedPlayer);
+    SimulationThread* simulation = new SimulationThread([&]() {
+        simulatedTree->resolvePositions();
+        return RenderSnapshot{*simulatedTree, simulatedPlayer->getWaterSupply(), simulatedPlayer->getFertiliserSupply(),
+            simulatedTimeline->getCurrentStep(), simulatedTimeline->getNumTimelines()};
+    }, 1000);
+    bool firstSnapshotMatches = simulation->getSnapshot()->currentStep == 0;
+    for (int i = 0; i < 5; i++) {
+        simulation->submit([&]() { simulatedTimeline->performAction(WateringAction(simulatedPlayer, simulatedTree, 5)); });
+        simulation->submit([&]() { simulatedTimeline->performAction(GrowingAction(simulatedPlayer, simulatedTree)); });
+    }
+    unsigned int simulatedChecksum = 0;
+    simulation->runAndWait([&]() { simulatedChecksum = simulatedTree->getChecksum(); });
+    const RenderSnapshot* simulatedSnapshot = simulation->getSnapshot();
+    if (firstSnapshotMatches && !simulation->isBusy() && simulatedSnapshot->currentStep == 10 &&
+        simulatedSnapshot->tree.getChecksum() == simulatedChecksum) {
+        std::cout << "Passed: Simulation thread published a snapshot of the tree after its commands" << std::endl;
+    } else {
+        std::cout << "Failed: Simulation thread did not publish a snapshot of the tree after its commands" << std::endl;
+    }
+    delete simulation;
+    delete simulatedTimeline;
+    delete simulatedTree;
+    delete simulatedPlayer;
+
+    std::cout << "Simulation thread test complete \n" << std::endl;
+
+    //Test that the state hash kept up to date as the tree changes matches a tree rebuilt from scratch, and that
+    //replaying the same commands gives the same hash after every step
+    Tree* hashedTree = buildBinaryTree(7, 5);
+    Player* hashedPlayer = new Player(1000, 1000);
+    Timeline* hashedTimeline = new Timeline(hashedTree, hashedPlayer);
+    for (int i = 0; i < 6; i++) {
+        hashedTimeline->performAction(WateringAction(hashedPlayer, hashedTree, 5));
+        hashedTimeline->performAction(GrowingAction(hashedPlayer, hashedTree));
+    }
+    hashedTimeline->performAction(PruningAction(hashedTree, hashedTree->getBranchIndexAt(hashedTree->getNumBranches()-1)));
+    hashedTimeline->reverseAction();
+    hashedTimeline->reverseAction();
+    hashedTimeline->performAction(PruningAction(hashedTree, 2));
+
+    std::stringstream hashedSave;
+    hashedTree->writeSave(hashedSave);
+    std::string hashedData = hashedSave.str();
+    Tree* rebuiltTree = Tree::fromSave(hashedData.data(), hashedData.size());
+
+    Tree* replayedHashTree = buildBinaryTree(7, 5);
+    Player* replayedHashPlayer = new Player(1000, 1000);
+    Timeline* replayedHashTimeline = new Timeline(replayedHashTree, replayedHashPlayer);
+    replayedHashTimeline->replayCommands(hashedTimeline->getSave().commands);
+
+    if (rebuiltTree != nullptr && rebuiltTree->getStateHash() == hashedTree->getStateHash() &&
+        hashedTimeline->getStateHashes().size() == 13 &&
+        replayedHashTimeline->getStateHashes() == hashedTimeline->getStateHashes() &&
+        hashedTimeline->getStateHashes().back() == hashedTree->getStateHash()) {
+        std::cout << "Passed: State hash matched a rebuilt tree and a replay after every step" << std::endl;
+    } else {
+        std::cout << "Failed: State hash did not match a rebuilt tree or a replay" << std::endl;
+    }
+    delete rebuiltTree;
+    delete hashedTimeline;
+    delete hashedTree;
+    delete hashedPlayer;
+    delete replayedHashTimeline;
+    delete replayedHashTree;
+    delete replayedHashPlayer;
+
+    //Travelling back must land on exactly the state that was recorded, even after the tree has filled up with water
+    Tree* travelledTree = buildBinaryTree(7, 9);
+    Player* travelledPlayer = new Player(1000, 1000);
+    Timeline* travelledTimeline = new Timeline(travelledTree, travelledPlayer, 4);
+    for (int i = 0; i < 30; i++) {
+        travelledTimeline->performAction(WateringAction(travelledPlayer, travelledTree, 3));
+        travelledTimeline->performAction(GrowingAction(travelledPlayer, travelledTree));
+    }
+    vector<unsigned int> travelledHashes = travelledTimeline->getStateHashes();
+
+    int travelMismatches = 0;
+    for (int step = travelledHashes.size()-2; step >= 0; step--) {
+        travelledTimeline->reverseAction();
+        if (travelledTree->getStateHash() != travelledHashes[step]) {
+            travelMismatches++;
+        }
+    }
+    for (int step = travelledHashes.size()-1; step >= 0; step -= 7) {
+        travelledTimeline->travelTo(travelledHashes.size()-1);
+        travelledTimeline->travelTo(step);
+        if (travelledTree->getStateHash() != travelledHashes[step]) {
+            travelMismatches++;
+        }
+    }
+    if (travelMismatches == 0) {
+        std::cout << "Passed: Travelling back gave the recorded state hash at every step" << std::endl;
+    } else {
+        std::cout << "Failed: Travelling back gave a different state hash at " << travelMismatches << " steps" << std::endl;
+    }
+    delete travelledTimeline;
+    delete travelledTree;
+    delete travelledPlayer;
+
+    std::cout << "State hash test complete \n" << std::endl;
+
+    //Test that a sweep tries every combination of parameters, that trees which may not branch never do, and that
+    //the results do not depend on the number of threads
+    GrowthConfig baseConfig;
+    vector<GrowthConfig> sweepConfigs = buildConfigGrid(baseConfig, {{"new-branch-probability", {0, 1}},
+        {"branch-growth-amount", {25, 50, 100}}});
+    SweepSettings sweepSettings;
+    sweepSettings.numSeeds = 4;
+    sweepSettings.numSteps = 8;
+    sweepSettings.numBranches = 3;
+    sweepSettings.numThreads = 3;
+    vector<SweepResult> parallelSweep = runSweep(sweepConfigs, sweepSettings);
+    sweepSettings.numThreads = 1;
+    vector<SweepResult> serialSweep = runSweep(sweepConfigs, sweepSettings);
+
+    bool sweepMatches = sweepConfigs.size() == 6 && parallelSweep.size() == 6 &&
+        sweepConfigs[1].branchGrowthAmount == 50 && sweepConfigs[3].newBranchProbability == 1 &&
+        parallelSweep[0].maxBranches == 3 && parallelSweep[5].minBranches > 3;
+    for (int i = 0; i < parallelSweep.size() && i < serialSweep.size(); i++) {
+        sweepMatches = sweepMatches && parallelSweep[i].meanBranches == serialSweep[i].meanBranches &&
+            parallelSweep[i].meanArea == serialSweep[i].meanArea && parallelSweep[i].meanDepth == serialSweep[i].meanDepth;
+    }
+    if (sweepMatches) {
+        std::cout << "Passed: Parameter sweep grew every config the same way on several threads as on one" << std::endl;
+    } else {
+        std::cout << "Failed: Parameter sweep did not grow every config the same way on several threads as on one" << std::endl;
+    }
+
+    std::cout << "Parameter sweep test complete \n" << std::endl;
+
+    //Test that each growth law splits the growth of a branch as described, and that trees grow with the law in their config
+    Branch quadraticBranch(1, 0, 0, 50, 10, 0, 0);
+    Branch linearBranch(1, 0, 0, 50, 10, 0, 0);
+    Branch logisticBranch(1, 0, 0, 50, 10, 0, 0);
+    GrowthConfig lawConfig;
+    float widthGrowth;
+    float lengthGrowth;
+    for (int i = 0; i < 20; i++) {
+        quadraticBranch.grow<QuadraticGrowth>(100, lawConfig, widthGrowth, lengthGrowth);
+        linearBranch.grow<LinearGrowth>(100, lawConfig, widthGrowth, lengthGrowth);
+        logisticBranch.grow<LogisticGrowth<1500>>(100, lawConfig, widthGrowth, lengthGrowth);
+    }
+    bool lawsMatch = abs(quadraticBranch.getSize() - 2500) < 1 && linearBranch.getSize() > quadraticBranch.getSize() &&
+        logisticBranch.getSize() < 1500 && logisticBranch.getSize() > 1000;
+
+    unsigned int lawChecksums[3];
+    for (int law = QUADRATIC_GROWTH; law <= LOGISTIC_GROWTH; law++) {
+        Tree* lawTree = buildBinaryTree(7, 9);
+        lawConfig.growthLaw = (GrowthLaw)law;
+        lawTree->setGrowthConfig(lawConfig);
+        for (int i = 0; i < 5; i++) {
+            float waterConsumed;
+            float nutrientsConsumed;
+            vector<float> widthIncreases;
+            vector<float> lengthIncreases;
+            vector<int> branchesGrown;
+            lawTree->addWater(10);
+            lawTree->addNutrients(10);
+            lawTree->grow(waterConsumed, nutrientsConsumed, widthIncreases, lengthIncreases, branchesGrown);
+        }
+        lawChecksums[law] = lawTree->getChecksum();
+        delete lawTree;
+    }
+    lawsMatch = lawsMatch && lawChecksums[0] != lawChecksums[1] && lawChecksums[1] != lawChecksums[2];
+    if (lawsMatch) {
+        std::cout << "Passed: Growth laws split branch growth as described" << std::endl;
+    } else {
+        std::cout << "Failed: Growth laws did not split branch growth as described" << std::endl;
+    }
+
+    std::cout << "Growth law test complete \n" << std::endl;
+
+    //Test that the direction stored in a branch gives the same corners as OpenCV and is kept when the branch is saved
+    Branch angledBranch(1, 0, 30, 60, 8, 100, 200);
+    Point2f branchCorners[4];
+    Point2f rectCorners[4];
+    angledBranch.getCorners(branchCorners);
+    angledBranch.getRect().points(rectCorners);
+    bool cornersMatch = true;
+    for (int i = 0; i < 4; i++) {
+        cornersMatch = cornersMatch && branchCorners[i].x == rectCorners[i].x && branchCorners[i].y == rectCorners[i].y;
+    }
+
+    std::stringstream branchStream;
+    angledBranch.writeBinary(branchStream);
+    Branch loadedBranch = Branch::readBinary(branchStream);
+    float angledTipX, angledTipY, loadedTipX, loadedTipY;
+    angledBranch.getTipPos(angledTipX, angledTipY);
+    loadedBranch.getTipPos(loadedTipX, loadedTipY);
+    if (cornersMatch && angledTipX == loadedTipX && angledTipY == loadedTipY && abs(angledTipX - (100 + 60*0.5f)) < 0.01) {
+        std::cout << "Passed: Branch direction gave the same corners and tip after loading" << std::endl;
+    } else {
+        std::cout << "Failed: Branch direction gave different corners or tip after loading" << std::endl;
+    }
+
+    std::cout << "Branch direction test complete \n" << std::endl;
+
+    //Test that positions worked out when they are needed match positions worked out after every change
+    Tree* lazyTree = buildBinaryTree(15, 5);
+    Tree* eagerTree = buildBinaryTree(15, 5);
+    for (int i = 0; i < 5; i++) {
+        float waterConsumed, nutrientsConsumed;
+        vector<float> widthIncreases, lengthIncreases;
+        vector<int> branchesGrown;
+        lazyTree->addWater(10);
+        lazyTree->addNutrients(10);
+        lazyTree->grow(waterConsumed, nutrientsConsumed, widthIncreases, lengthIncreases, branchesGrown);
+
+        widthIncreases.clear();
+        lengthIncreases.clear();
+        branchesGrown.clear();
+        eagerTree->addWater(10);
+        eagerTree->addNutrients(10);
+        eagerTree->grow(waterConsumed, nutrientsConsumed, widthIncreases, lengthIncreases, branchesGrown);
+        eagerTree->updateBranchPos();
+    }
+    bool lazyMatches = lazyTree->getStateHash() == eagerTree->getStateHash() &&
+        lazyTree->getChecksum() == eagerTree->getChecksum();
+
+    //Grows the rest of the tree while a subtree is cut off, so only the subtree has to move when it is put back
+    DetachedBranches detachedBranches;
+    lazyTree->pruneBranch(3, detachedBranches);
+    vector<float> sizeChanges(lazyTree->getNumBranches(), -2);
+    lazyTree->modifyBranches(sizeChanges, sizeChanges);
+    lazyTree->getChecksum();
+    lazyTree->restoreBranches(detachedBranches);
+    float staleX = lazyTree->getBranch(3)->getRect().center.x;
+    float staleY = lazyTree->getBranch(3)->getRect().center.y;
+    Tree fullyMovedTree(*lazyTree);
+    fullyMovedTree.updateBranchPos();
+    lazyMatches = lazyMatches && lazyTree->getChecksum() == fullyMovedTree.getChecksum() &&
+        (lazyTree->getBranch(3)->getRect().center.x != staleX || lazyTree->getBranch(3)->getRect().center.y != staleY);
+    if (lazyMatches) {
+        std::cout << "Passed: Positions resolved when needed matched positions updated after every change" << std::endl;
+    } else {
+        std::cout << "Failed: Positions resolved when needed did not match positions updated after every change" << std::endl;
+    }
+    delete lazyTree;
+    delete eagerTree;
+
+    std::cout << "Lazy position test complete \n" << std::endl;
+
+    //Test that the vascular supply model shares out the whole supply, and that pruning only shares out the supply
+    //below the cut again, giving the same shares as working them out from scratch. Branch 7 is below the parent of
+    //branch 4, so the second prune shares out the supply below the first one again.
+    Tree* suppliedTree = buildBinaryTree(31, 7);
+    Tree* resuppliedTree = buildBinaryTree(31, 7);
+    float totalShare = 0;
+    for (int i = 0; i < 31; i++) {
+        totalShare += suppliedTree->getSupplyShare(i);
+    }
+    bool supplyMatches = abs(totalShare - 1) < 0.0001 && suppliedTree->getSupplyShare(0) > suppliedTree->getSupplyShare(1) &&
+        suppliedTree->getSupplyShare(1) > suppliedTree->getSupplyShare(3) && suppliedTree->getSupplyShare(31) == 0;
+
+    DetachedBranches suppliedBranches[2];
+    DetachedBranches resuppliedBranches[2];
+    suppliedTree->pruneBranch(7, suppliedBranches[0]);
+    suppliedTree->pruneBranch(4, suppliedBranches[1]);
+    resuppliedTree->pruneBranch(7, resuppliedBranches[0]);
+    resuppliedTree->pruneBranch(4, resuppliedBranches[1]);
+    totalShare = 0;
+    for (int i = 0; i < 31; i++) {
+        totalShare += suppliedTree->getSupplyShare(i);
+        supplyMatches = supplyMatches && suppliedTree->getSupplyShare(i) == resuppliedTree->getSupplyShare(i);
+    }
+    supplyMatches = supplyMatches && abs(totalShare - 1) < 0.0001 && suppliedTree->getSupplyShare(4) == 0 &&
+        suppliedTree->getSupplyShare(7) == 0;
+
+    //Undoing both prunes gives back the shares of a tree that was never pruned
+    Tree* unprunedTree = buildBinaryTree(31, 7);
+    suppliedTree->restoreBranches(suppliedBranches[1]);
+    suppliedTree->restoreBranches(suppliedBranches[0]);
+    resuppliedTree->restoreBranches(resuppliedBranches[1]);
+    resuppliedTree->restoreBranches(resuppliedBranches[0]);
+    for (int i = 0; i < 31; i++) {
+        supplyMatches = supplyMatches && abs(suppliedTree->getSupplyShare(i) - unprunedTree->getSupplyShare(i)) < 0.000001;
+    }
+    delete unprunedTree;
+
+    //Growing with vascular supply gives the branches near the trunk more to grow with
+    GrowthConfig vascularConfig;
+    vascularConfig.supplyModel = VASCULAR_SUPPLY;
+    resuppliedTree->setGrowthConfig(vascularConfig);
+    float supplyWaterConsumed, supplyNutrientsConsumed;
+    vector<float> supplyWidthIncreases, supplyLengthIncreases;
+    vector<int> supplyBranchesGrown;
+    suppliedTree->addWater(10);
+    suppliedTree->addNutrients(10);
+    suppliedTree->grow(supplyWaterConsumed, supplyNutrientsConsumed, supplyWidthIncreases, supplyLengthIncreases, supplyBranchesGrown);
+    vector<float> evenWidthIncreases = supplyWidthIncreases;
+    supplyWidthIncreases.clear();
+    supplyLengthIncreases.clear();
+    supplyBranchesGrown.clear();
+    resuppliedTree->addWater(10);
+    resuppliedTree->addNutrients(10);
+    resuppliedTree->grow(supplyWaterConsumed, supplyNutrientsConsumed, supplyWidthIncreases, supplyLengthIncreases, supplyBranchesGrown);
+    supplyMatches = supplyMatches && supplyWidthIncreases[0] > evenWidthIncreases[0] &&
+        supplyWidthIncreases.back() < evenWidthIncreases.back();
+    if (supplyMatches) {
+        std::cout << "Passed: Vascular supply was shared out by width and only below a prune" << std::endl;
+    } else {
+        std::cout << "Failed: Vascular supply was not shared out by width and only below a prune" << std::endl;
+    }
+    delete suppliedTree;
+    delete resuppliedTree;
+
+    std::cout << "Vascular supply test complete \n" << std::endl;
+
+    //Test that branches crossing each other are found to overlap, and that trees grown while avoiding overlaps have
+    //fewer branches overlapping branches other than their parents and siblings
+    Branch uprightBranch(0, -1, 0, 50, 10, 0, 0);
+    Branch crossingBranch(1, -1, 90, 50, 10, -25, -25);
+    Branch distantBranch(2, -1, 45, 50, 10, 100, 0);
+    bool overlapsMatch = uprightBranch.overlaps(crossingBranch) && crossingBranch.overlaps(uprightBranch) &&
+        !uprightBranch.overlaps(distantBranch) && !crossingBranch.overlaps(distantBranch);
+
+    int overlapCounts[2];
+    for (int avoid = 0; avoid < 2; avoid++) {
+        Tree* overlapTree = buildBinaryTree(1, 1);
+        GrowthConfig overlapConfig;
+        overlapConfig.sproutAttempts = avoid*8;
+        overlapTree->setGrowthConfig(overlapConfig);
+        for (int step = 0; step < 8; step++) {
+            float waterConsumed, nutrientsConsumed;
+            vector<float> widthIncreases, lengthIncreases;
+            vector<int> branchesGrown;
+            overlapTree->addWater(10);
+            overlapTree->addNutrients(10);
+            overlapTree->grow(waterConsumed, nutrientsConsumed, widthIncreases, lengthIncreases, branchesGrown);
+        }
+
+        overlapTree->resolvePositions();
+        overlapCounts[avoid] = 0;
+        for (int i = 0; i < overlapTree->getNumBranches(); i++) {
+            for (int j = i+1; j < overlapTree->getNumBranches(); j++) {
+                const Branch* branch = overlapTree->getBranch(overlapTree->getBranchIndexAt(i));
+                const Branch* otherBranch = overlapTree->getBranch(overlapTree->getBranchIndexAt(j));
+                if (branch->getParentIndex() != otherBranch->getIndex() && otherBranch->getParentIndex() != branch->getIndex() &&
+                    branch->getParentIndex() != otherBranch->getParentIndex() && branch->overlaps(*otherBranch)) {
+                    overlapCounts[avoid]++;
+                }
+            }
+        }
+        delete overlapTree;
+    }
+    if (overlapsMatch && overlapCounts[1] < overlapCounts[0]) {
+        std::cout << "Passed: New branches avoided overlapping other branches" << std::endl;
+    } else {
+        std::cout << "Failed: New branches did not avoid overlapping other branches" << std::endl;
+    }
+
+    std::cout << "Branch overlap test complete \n" << std::endl;
+
+    //Test that a tree that has withered away, whose branches are no longer numbers, can be saved as JSON and loaded
+    Tree* witheredTree = new Tree(0, 0, new Branch(0, 0, 1, 50, 10, 400, 600));
+    for (int step = 0; step < 20 && isfinite(witheredTree->getTotalArea()); step++) {
+        float waterConsumed, nutrientsConsumed;
+        vector<float> widthIncreases, lengthIncreases;
+        vector<int> branchesGrown;
+        witheredTree->grow(waterConsumed, nutrientsConsumed, widthIncreases, lengthIncreases, branchesGrown);
+    }
+    Player witheredPlayer(0, 0);
+    Tree* loadedWitheredTree = nullptr;
+    Player* loadedWitheredPlayer = nullptr;
+    bool witheredLoaded = !isfinite(witheredTree->getTotalArea()) &&
+        writeJsonSave("test_withered.json", witheredTree, &witheredPlayer) &&
+        loadJsonSave("test_withered.json", loadedWitheredTree, loadedWitheredPlayer);
+    if (witheredLoaded && loadedWitheredTree->getNumBranches() == witheredTree->getNumBranches() &&
+        !isfinite(loadedWitheredTree->getTotalArea())) {
+        std::cout << "Passed: Withered tree was saved as JSON and loaded back" << std::endl;
+    } else {
+        std::cout << "Failed: Withered tree could not be saved as JSON and loaded back" << std::endl;
+    }
+    delete witheredTree;
+    delete loadedWitheredTree;
+    delete loadedWitheredPlayer;
+    remove("test_withered.json");
+
+    std::cout << "Withered save test complete \n" << std::endl;
+
+    //Test that binary saves with a branch index used twice, or a parent that is not in the tree, are rejected
+    Tree* linkedTree = buildBinaryTree(7, 1);
+    std::stringstream linkedSave;
+    linkedTree->writeSave(linkedSave);
+    std::string duplicatedData = linkedSave.str();
+    std::string unlinkedData = linkedSave.str();
+    int* duplicatedIndices = reinterpret_cast<int*>(&duplicatedData[sizeof(TreeSaveHeader)]);
+    duplicatedIndices[2] = duplicatedIndices[1];
+    int* unlinkedParents = reinterpret_cast<int*>(&unlinkedData[sizeof(TreeSaveHeader)]) + 7;
+    unlinkedParents[6] = 1000;
+    Tree* duplicatedTree = Tree::fromSave(duplicatedData.data(), duplicatedData.size());
+    Tree* unlinkedTree = Tree::fromSave(unlinkedData.data(), unlinkedData.size());
+    if (duplicatedTree == nullptr && unlinkedTree == nullptr) {
+        std::cout << "Passed: Binary saves with repeated or missing branches were rejected" << std::endl;
+    } else {
+        std::cout << "Failed: Binary saves with repeated or missing branches were not rejected" << std::endl;
+    }
+    delete linkedTree;
+    delete duplicatedTree;
+    delete unlinkedTree;
+
+    //Test that JSON trees with a repeated index, a missing child, an index past the maximum or a loop of parents are rejected
+    std::string damagedJsonTrees[] = {
+        "{\"maxIndex\":3,\"branchList\":[{\"index\":0,\"parentIndex\":-1,\"childIndices\":[1]},"
+            "{\"index\":1,\"parentIndex\":0,\"childIndices\":[]},{\"index\":1,\"parentIndex\":0,\"childIndices\":[]}]}",
+        "{\"maxIndex\":2,\"branchList\":[{\"index\":0,\"parentIndex\":-1,\"childIndices\":[1,99]},"
+            "{\"index\":1,\"parentIndex\":0,\"childIndices\":[]}]}",
+        "{\"maxIndex\":1,\"branchList\":[{\"index\":0,\"parentIndex\":-1,\"childIndices\":[5]},"
+            "{\"index\":5,\"parentIndex\":0,\"childIndices\":[]}]}",
+        "{\"maxIndex\":3,\"branchList\":[{\"index\":0,\"parentIndex\":-1,\"childIndices\":[]},"
+            "{\"index\":1,\"parentIndex\":2,\"childIndices\":[2]},{\"index\":2,\"parentIndex\":1,\"childIndices\":[1]}]}"
+    };
+    int damagedJsonLoaded = 0;
+    for (int i = 0; i < 4; i++) {
+        JsonReader damagedReader(damagedJsonTrees[i].data(), damagedJsonTrees[i].size());
+        try {
+            delete Tree::readJson(damagedReader);
+            damagedJsonLoaded++;
+        } catch (JsonReadError& e) {
+            std::cout << "Rejected damaged tree " << i << ": " << e.what() << std::endl;
+        }
+    }
+    if (damagedJsonLoaded == 0) {
+        std::cout << "Passed: JSON trees with repeated, missing or looping branches were rejected" << std::endl;
+    } else {
+        std::cout << "Failed: " << damagedJsonLoaded << " damaged JSON trees were loaded" << std::endl;
+    }
+
+    //Test that saves with a huge branch index are rejected instead of running out of memory
+    Tree* hugeTree = new Tree(10, 20, new Branch(0, -1, 0, 50, 10, 0, 0));
+    Player hugePlayer(0, 0);
+    std::stringstream hugeSave;
+    hugeTree->writeSave(hugeSave);
+    std::string hugeData = hugeSave.str();
+    TreeSaveHeader* hugeHeader = reinterpret_cast<TreeSaveHeader*>(&hugeData[0]);
+    hugeHeader->maxIndex = 2000000000;
+    reinterpret_cast<int*>(&hugeData[sizeof(TreeSaveHeader)])[0] = 1999999999;
+    Tree* hugeBinaryTree = Tree::fromSave(hugeData.data(), hugeData.size());
+
+    writeJsonSave("test_huge.json", hugeTree, &hugePlayer);
+    std::string hugeJson;
+    {
+        std::ifstream hugeFile("test_huge.json");
+        std::stringstream hugeText;
+        hugeText << hugeFile.rdbuf();
+        hugeJson = hugeText.str();
+    }
+    hugeJson.replace(hugeJson.find("\"index\":0"), 9, "\"index\":1999999999");
+    hugeJson.replace(hugeJson.find("\"maxIndex\":1"), 12, "\"maxIndex\":2000000000");
+    {
+        std::ofstream hugeFile("test_huge.json");
+        hugeFile << hugeJson;
+    }
+    Tree* hugeJsonTree = nullptr;
+    Player* hugeJsonPlayer = nullptr;
+    bool hugeJsonLoaded = loadSave("test_huge.json", hugeJsonTree, hugeJsonPlayer);
+    if (hugeBinaryTree == nullptr && !hugeJsonLoaded) {
+        std::cout << "Passed: Saves with a huge branch index were rejected" << std::endl;
+    } else {
+        std::cout << "Failed: Saves with a huge branch index were not rejected" << std::endl;
+    }
+    delete hugeTree;
+    delete hugeBinaryTree;
+    delete hugeJsonTree;
+    delete hugeJsonPlayer;
+    remove("test_huge.json");
+
+    std::cout << "Damaged save test complete \n" << std::endl;
+
+    //Test that every save format keeps the growth config, so a compact save replays with the config it was grown with
+    GrowthConfig savedConfig;
+    savedConfig.newBranchProbability = 0.9;
+    savedConfig.areaPerSupply = 30;
+    savedConfig.growthLaw = LINEAR_GROWTH;
+    savedConfig.supplyModel = VASCULAR_SUPPLY;
+    Tree* configuredTree = buildBinaryTree(7, 3);
+    configuredTree->setGrowthConfig(savedConfig);
+    Player* configuredPlayer = new Player(1000, 1000);
+    Timeline* configuredTimeline = new Timeline(configuredTree, configuredPlayer);
+    for (int i = 0; i < 5; i++) {
+        configuredTimeline->performAction(WateringAction(configuredPlayer, configuredTree, 5));
+        configuredTimeline->performAction(GrowingAction(configuredPlayer, configuredTree));
+    }
+    TimelineSave configuredSave = configuredTimeline->getSave();
+
+    int configMismatches = 0;
+    const char* configPaths[] = {"test_config.json", "test_config.bin", "test_config.pack"};
+    for (int i = 0; i < 3; i++) {
+        Tree* loadedConfiguredTree = nullptr;
+        Player* loadedConfiguredPlayer = nullptr;
+        if (!writeSave(configPaths[i], configuredTree, configuredPlayer) ||
+            !loadSave(configPaths[i], loadedConfiguredTree, loadedConfiguredPlayer) ||
+            loadedConfiguredTree->getGrowthConfig().newBranchProbability != savedConfig.newBranchProbability ||
+            loadedConfiguredTree->getGrowthConfig().areaPerSupply != savedConfig.areaPerSupply ||
+            loadedConfiguredTree->getGrowthConfig().growthLaw != LINEAR_GROWTH ||
+            loadedConfiguredTree->getGrowthConfig().supplyModel != VASCULAR_SUPPLY) {
+            configMismatches++;
+        }
+        delete loadedConfiguredTree;
+        delete loadedConfiguredPlayer;
+        remove(configPaths[i]);
+    }
+
+    Tree* replayedConfiguredTree = nullptr;
+    Player* replayedConfiguredPlayer = nullptr;
+    if (!writeJsonSave("test_config.json", configuredTree, configuredPlayer, &configuredSave) ||
+        !loadJsonSave("test_config.json", replayedConfiguredTree, replayedConfiguredPlayer) ||
+        replayedConfiguredTree->getChecksum() != configuredTree->getChecksum()) {
+        configMismatches++;
+    }
+    remove("test_config.json");
+
+    if (configMismatches == 0) {
+        std::cout << "Passed: Saves kept the growth config of the tree" << std::endl;
+    } else {
+        std::cout << "Failed: " << configMismatches << " saves did not keep the growth config of the tree" << std::endl;
+    }
+    delete replayedConfiguredTree;
+    delete replayedConfiguredPlayer;
+    delete configuredTimeline;
+    delete configuredTree;
+    delete configuredPlayer;
+
+    std::cout << "Growth config save test complete \n" << std::endl;
+
+    delete recoveredTimeline;
+    delete recoveredTree;
+    delete recoveredPlayer;
+    delete autosavedTree;
+    delete autosavedPlayer;
+    remove("test_autosave.json");
+    remove("test_autosave.journal");
+
+    delete recordedTimeline;
+    delete recordedTree;
+    delete recordedPlayer;
+    delete replayedTimeline;
+    delete replayedTree;
+    delete replayedPlayer;
+
     //Testing Pruning action
     // Create a few more branches for testing
-    Branch* branch1 = new Branch(1, 0, 5, 30, 5, 1, 1);
-    Branch* branch2 = new Branch(2, 0, 10, 40, 6, 2, 2);
+    Branch branch1(1, 0, 5, 30, 5, 1, 1);
+    Branch branch2(2, 0, 10, 40, 6, 2, 2);
     
     // Use the correct method to add branches (use addBranches)
-    vector<Branch*> branchesToAdd = {branch1, branch2};
+    vector<Branch> branchesToAdd = {branch1, branch2};
     myTree.addBranches(branchesToAdd);  // addBranches accepts a vector of branches
 
     // Print initial tree data
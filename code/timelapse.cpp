@@ -0,0 +1,32 @@
+#include <iostream>
+#include "SaveFormat.h"
+#include "TimelapseExporter.h"
+
+using namespace std;
+
+//Exports the timeline of a JSON save as a time-lapse video or image sequence
+int main(int argc, char* argv[]){
+    if(argc != 3){
+        cout << "Usage: " << argv[0] << " <JSON save> <output video>" << endl;
+        cout << "Outputs ending in .png, .jpg or .bmp are written as numbered images, and .mp4 outputs use the mp4v codec" << endl;
+        return 1;
+    }
+
+    JsonSave save;
+    if(!readJsonSave(argv[1], save)){
+        cout << "Could not read " << argv[1] << endl;
+        return 1;
+    }
+    if(!save.timeline){
+        cout << argv[1] << " has no timeline to export. Only compact saves store the actions that grew the tree." << endl;
+        return 1;
+    }
+
+    if(!exportTimelapse(*save.timeline, argv[2])){
+        cout << "Could not export " << argv[1] << " to " << argv[2] << endl;
+        return 1;
+    }
+
+    cout << "Exported " << save.timeline->commands.size()+1 << " frames to " << argv[2] << endl;
+    return 0;
+}